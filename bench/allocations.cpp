@@ -0,0 +1,85 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "allocations.hpp"
+
+std::atomic<uint64_t> allocation_count{ 0 };
+
+namespace
+{
+    void* counted_alloc(const std::size_t size, const std::size_t alignment)
+    {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+        void* p = alignment > alignof(std::max_align_t)
+            ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+            : std::malloc(size == 0 ? 1 : size);
+        if (p == nullptr)
+            throw std::bad_alloc();
+        return p;
+    }
+}
+
+void* operator new(const std::size_t size)
+{
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new[](const std::size_t size)
+{
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Number of global operator new calls in this process. Counted by the replacements in allocations.cpp.
+ */
+extern std::atomic<uint64_t> allocation_count;
+
+/**
+ * @brief Counts the allocations made by fn.
+ */
+template<typename Fn>
+uint64_t count_allocations(Fn&& fn)
+{
+    const uint64_t before = allocation_count.load(std::memory_order_relaxed);
+    fn();
+    return allocation_count.load(std::memory_order_relaxed) - before;
+}
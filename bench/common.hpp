@@ -0,0 +1,86 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Keeps the compiler from optimizing away a benchmarked result.
+ */
+template<typename T>
+void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Runs fn repeatedly and returns the median wall time of a single run in nanoseconds.
+ */
+template<typename Fn>
+double median_ns(Fn&& fn, const int repetitions = 15)
+{
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (auto i = 0; i < repetitions; ++i)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        fn();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+    }
+    std::ranges::nth_element(samples, samples.begin() + samples.size() / 2);
+    return samples[samples.size() / 2];
+}
+
+/**
+ * @brief Reference cycles per nanosecond of the cycle counter, or 0 if there is none on this target.
+ */
+inline double cycles_per_ns()
+{
+    #if defined(__x86_64__) || defined(__i386__)
+    static const double ratio = []
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        const uint64_t tsc_begin = __rdtsc();
+        while (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(20))
+        {
+        }
+        const uint64_t tsc_end = __rdtsc();
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        return static_cast<double>(tsc_end - tsc_begin) / elapsed;
+    }();
+    return ratio;
+    #else
+    return 0.0;
+    #endif
+}
+
+/**
+ * @brief Builds a source of roughly the requested size by repeating a representative snippet.
+ */
+inline std::string make_source(const size_t bytes)
+{
+    constexpr std::string_view snippet =
+        "import math;\n"
+        "@pure function dot(a: f64[], b: f64[], n: u32) -> f64\n"
+        "{\n"
+        "    var sum: f64 = 0.0; // accumulator\n"
+        "    for (var i: u32 = 0; i < n; i += 1) { sum += a[i] * b[i]; }\n"
+        "    return sum;\n"
+        "}\n"
+        "class Vec extends Base { public var x: f64; public var y: f64; }\n";
+
+    std::string src;
+    src.reserve(bytes + snippet.size());
+    while (src.size() < bytes)
+    {
+        src += snippet;
+    }
+    return src;
+}
@@ -0,0 +1,127 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include "corpus.hpp"
+
+namespace
+{
+    void usage()
+    {
+        std::cerr << "usage: nightglow-corpus [--size=N[K|M|G]] [--seed=N] [--imports=N] [--classes=W] [--functions=W]\n"
+                     "                        [--globals=W] [--comments=PCT] [--literals=PCT] [--annotations=PCT]\n"
+                     "                        [--depth=N] [-o file]\n";
+    }
+
+    std::optional<uint64_t> parse_number(const std::string& text)
+    {
+        if (text.empty())
+            return std::nullopt;
+        char* end = nullptr;
+        uint64_t value = std::strtoull(text.c_str(), &end, 0);
+        switch (*end)
+        {
+            case 'k': case 'K': value <<= 10; ++end; break;
+            case 'm': case 'M': value <<= 20; ++end; break;
+            case 'g': case 'G': value <<= 30; ++end; break;
+            default: break;
+        }
+        if (*end != '\0')
+            return std::nullopt;
+        return value;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    corpus_options options;
+    std::string output;
+
+    const std::pair<std::string_view, uint32_t corpus_options::*> knobs[] = {
+        { "--imports=", &corpus_options::imports },
+        { "--classes=", &corpus_options::class_weight },
+        { "--functions=", &corpus_options::function_weight },
+        { "--globals=", &corpus_options::global_weight },
+        { "--comments=", &corpus_options::comment_percent },
+        { "--literals=", &corpus_options::literal_percent },
+        { "--annotations=", &corpus_options::annotation_percent },
+        { "--depth=", &corpus_options::max_depth },
+    };
+
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help")
+        {
+            usage();
+            return 0;
+        }
+        if (arg == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+            continue;
+        }
+
+        const auto eq = arg.find('=');
+        const std::optional<uint64_t> value = eq == std::string::npos ? std::nullopt : parse_number(arg.substr(eq + 1));
+        const std::string_view key = std::string_view(arg).substr(0, eq == std::string::npos ? arg.size() : eq + 1);
+        if (!value)
+        {
+            std::cerr << "nightglow-corpus: invalid argument '" << arg << "'\n";
+            usage();
+            return 2;
+        }
+
+        if (key == "--size=")
+            options.bytes = *value;
+        else if (key == "--seed=")
+            options.seed = *value;
+        else
+        {
+            bool known = false;
+            for (const auto& [name, field] : knobs)
+            {
+                if (key == name)
+                {
+                    options.*field = static_cast<uint32_t>(*value);
+                    known = true;
+                }
+            }
+            if (!known)
+            {
+                std::cerr << "nightglow-corpus: unknown option '" << arg << "'\n";
+                usage();
+                return 2;
+            }
+        }
+    }
+
+    if (options.class_weight + options.function_weight + options.global_weight == 0)
+    {
+        std::cerr << "nightglow-corpus: at least one of --classes, --functions and --globals must be non-zero\n";
+        return 2;
+    }
+
+    CorpusGenerator generator(options);
+    if (output.empty())
+    {
+        std::ios::sync_with_stdio(false);
+        generator.generate(std::cout);
+        return std::cout ? 0 : 1;
+    }
+
+    std::ofstream out(output, std::ios::binary);
+    if (!out)
+    {
+        std::cerr << "nightglow-corpus: cannot open '" << output << "'\n";
+        return 1;
+    }
+    generator.generate(out);
+    return out ? 0 : 1;
+}
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Knobs for the synthetic corpus. Weights are relative, percentages are per opportunity.
+ */
+struct corpus_options
+{
+    uint64_t bytes = 1u << 20;
+    uint64_t seed = 0x6e6967687467ull;
+    uint32_t imports = 6;
+    uint32_t class_weight = 1;
+    uint32_t function_weight = 3;
+    uint32_t global_weight = 1;
+    uint32_t comment_percent = 25;
+    uint32_t literal_percent = 35;
+    uint32_t annotation_percent = 30;
+    uint32_t max_depth = 3;
+};
+
+/**
+ * @brief Emits syntactically realistic Nightglow programs. The output only depends on the options,
+ * so the same seed always produces the same bytes on every platform.
+ */
+class CorpusGenerator
+{
+public:
+    explicit CorpusGenerator(const corpus_options& options) : options(options), state(options.seed)
+    {
+    }
+
+    /**
+     * @brief Streams at least options.bytes bytes of source to out, ending on a whole declaration.
+     */
+    void generate(std::ostream& out)
+    {
+        uint64_t written = 0;
+        for (uint32_t i = 0; i < options.imports; ++i)
+        {
+            buffer += "import ";
+            buffer += pick(modules);
+            buffer += '.';
+            identifier();
+            buffer += ";\n";
+        }
+        buffer += '\n';
+
+        const uint32_t total = options.class_weight + options.function_weight + options.global_weight;
+        while (written + buffer.size() < options.bytes && total > 0)
+        {
+            const uint32_t roll = next(total);
+            if (roll < options.class_weight)
+                class_declaration();
+            else if (roll < options.class_weight + options.function_weight)
+                function_declaration(0);
+            else
+                global_declaration();
+            buffer += '\n';
+
+            if (buffer.size() >= flush_size)
+            {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                written += buffer.size();
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    /**
+     * @brief Generates the whole corpus into memory. Only for sizes that comfortably fit.
+     */
+    std::string generate()
+    {
+        std::ostringstream out;
+        generate(out);
+        return std::move(out).str();
+    }
+
+private:
+    static constexpr size_t flush_size = 1u << 16;
+    static constexpr std::string_view modules[] = { "std", "core", "app", "net", "gfx", "util" };
+    static constexpr std::string_view words[] = {
+        "value", "count", "index", "node", "buffer", "size", "left", "right", "result", "item",
+        "offset", "length", "state", "token", "cache", "entry", "scale", "width", "height", "total"
+    };
+    static constexpr std::string_view types[] = {
+        "u8", "i8", "u16", "i16", "u32", "i32", "u64", "i64", "f32", "f64", "string", "boolean"
+    };
+    static constexpr std::string_view annotations[] = {
+        "@pure", "@volatile", "@nodiscard", "@lazy", "@deprecated", "@tailrec", "@packed"
+    };
+    static constexpr std::string_view binary_operators[] = {
+        "+", "-", "*", "/", "%", "&", "|", "^", "<<", ">>", "==", "!=", "<", "<=", ">", ">=", "&&", "||"
+    };
+    static constexpr std::string_view assign_operators[] = { "=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=" };
+    static constexpr std::string_view comments[] = {
+        "// keep this in sync with the layout above",
+        "// fast path: nothing to do",
+        "/* the caller guarantees the range is valid */",
+        "// TODO: revisit once the allocator lands",
+        "/* see the module header for the invariants */"
+    };
+
+    const corpus_options options;
+    uint64_t state;
+    std::string buffer;
+    uint32_t indent_level = 0;
+
+    // splitmix64: tiny, fast and identical everywhere, unlike the <random> distributions
+    uint32_t next(const uint32_t bound)
+    {
+        uint64_t z = state += 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        z ^= z >> 31;
+        return bound == 0 ? 0 : static_cast<uint32_t>(z % bound);
+    }
+
+    bool chance(const uint32_t percent)
+    {
+        return next(100) < percent;
+    }
+
+    template<size_t N>
+    std::string_view pick(const std::string_view (&items)[N])
+    {
+        return items[next(N)];
+    }
+
+    void indent()
+    {
+        buffer.append(indent_level * 4, ' ');
+    }
+
+    void identifier()
+    {
+        buffer += pick(words);
+        if (chance(40))
+        {
+            buffer += '_';
+            buffer += pick(words);
+        }
+        if (chance(20))
+            buffer += std::to_string(next(100));
+    }
+
+    void type_name()
+    {
+        buffer += pick(types);
+        if (chance(10))
+            buffer += "[]";
+    }
+
+    void comment()
+    {
+        if (!chance(options.comment_percent))
+            return;
+        indent();
+        buffer += pick(comments);
+        buffer += '\n';
+    }
+
+    void literal()
+    {
+        switch (next(7))
+        {
+            case 0: buffer += std::to_string(next(1u << 20)); break;
+            case 1:
+            {
+                char hex[16];
+                std::snprintf(hex, sizeof(hex), "0x%X", next(1u << 24));
+                buffer += hex;
+                break;
+            }
+            case 2:
+            {
+                buffer += "0b";
+                for (uint32_t bits = next(1u << 8) | 0x100u; bits > 1; bits >>= 1)
+                    buffer += static_cast<char>('0' + (bits & 1));
+                break;
+            }
+            case 3: buffer += std::to_string(next(1000)) + "." + std::to_string(next(1000)); break;
+            case 4: buffer += '"'; buffer += pick(words); buffer += ' '; buffer += pick(words); buffer += '"'; break;
+            case 5: buffer += chance(50) ? "true" : "false"; break;
+            default: buffer += "null"; break;
+        }
+    }
+
+    void operand(const uint32_t depth)
+    {
+        if (chance(options.literal_percent))
+        {
+            literal();
+            return;
+        }
+
+        identifier();
+        if (depth < options.max_depth && chance(15))
+        {
+            buffer += '(';
+            const uint32_t args = next(3);
+            for (uint32_t i = 0; i < args; ++i)
+            {
+                if (i > 0)
+                    buffer += ", ";
+                expression(depth + 1);
+            }
+            buffer += ')';
+        }
+        else if (chance(10))
+        {
+            buffer += '.';
+            identifier();
+        }
+        else if (chance(10))
+        {
+            buffer += '[';
+            operand(depth + 1);
+            buffer += ']';
+        }
+    }
+
+    void expression(const uint32_t depth)
+    {
+        if (depth < options.max_depth && chance(10))
+        {
+            buffer += '(';
+            expression(depth + 1);
+            buffer += ')';
+        }
+        else
+            operand(depth);
+
+        const uint32_t terms = depth < options.max_depth ? next(3) : 0;
+        for (uint32_t i = 0; i < terms; ++i)
+        {
+            buffer += ' ';
+            buffer += pick(binary_operators);
+            buffer += ' ';
+            operand(depth + 1);
+        }
+    }
+
+    void variable(const bool allow_const)
+    {
+        buffer += allow_const && chance(30) ? "const " : "var ";
+        identifier();
+        buffer += ": ";
+        type_name();
+        buffer += " = ";
+        expression(0);
+        buffer += ";\n";
+    }
+
+    void block(const uint32_t depth)
+    {
+        indent();
+        buffer += "{\n";
+        ++indent_level;
+        const uint32_t statements = 2 + next(5);
+        for (uint32_t i = 0; i < statements; ++i)
+        {
+            statement(depth + 1);
+        }
+        --indent_level;
+        indent();
+        buffer += "}\n";
+    }
+
+    void statement(const uint32_t depth)
+    {
+        comment();
+        const uint32_t roll = depth < options.max_depth ? next(10) : next(4);
+        indent();
+        switch (roll)
+        {
+            case 0:
+            case 1: variable(true); break;
+            case 2:
+                identifier();
+                buffer += ' ';
+                buffer += pick(assign_operators);
+                buffer += ' ';
+                expression(0);
+                buffer += ";\n";
+                break;
+            case 3:
+                buffer += "return ";
+                expression(0);
+                buffer += ";\n";
+                break;
+            case 4:
+            case 5:
+                buffer += "if (";
+                expression(0);
+                buffer += ")\n";
+                block(depth);
+                if (chance(40))
+                {
+                    indent();
+                    buffer += "else\n";
+                    block(depth);
+                }
+                break;
+            case 6:
+                buffer += "for (var i: u32 = 0; i < ";
+                operand(depth);
+                buffer += "; i += 1)\n";
+                block(depth);
+                break;
+            case 7:
+                buffer += "while (";
+                expression(0);
+                buffer += ")\n";
+                block(depth);
+                break;
+            default:
+                identifier();
+                buffer += '(';
+                expression(0);
+                buffer += ");\n";
+                break;
+        }
+    }
+
+    void parameters()
+    {
+        buffer += '(';
+        const uint32_t count = next(4);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (i > 0)
+                buffer += ", ";
+            identifier();
+            buffer += ": ";
+            type_name();
+        }
+        buffer += ')';
+    }
+
+    void function_declaration(const uint32_t depth)
+    {
+        comment();
+        if (chance(options.annotation_percent))
+        {
+            indent();
+            buffer += pick(annotations);
+            buffer += '\n';
+        }
+        indent();
+        if (depth > 0)
+            buffer += chance(70) ? "public " : "private ";
+        if (chance(10))
+            buffer += "inline ";
+        buffer += "function ";
+        identifier();
+        parameters();
+        buffer += " -> ";
+        if (chance(20))
+            buffer += "void";
+        else
+            type_name();
+        buffer += '\n';
+        block(depth);
+    }
+
+    void class_declaration()
+    {
+        comment();
+        if (chance(options.annotation_percent))
+        {
+            buffer += pick(annotations);
+            buffer += '\n';
+        }
+        if (chance(20))
+            buffer += "final ";
+        buffer += "class ";
+        identifier();
+        if (chance(40))
+        {
+            buffer += " extends ";
+            identifier();
+        }
+        buffer += "\n{\n";
+        ++indent_level;
+        const uint32_t fields = 1 + next(4);
+        for (uint32_t i = 0; i < fields; ++i)
+        {
+            indent();
+            buffer += chance(60) ? "public " : chance(50) ? "private " : "protected ";
+            variable(false);
+        }
+        const uint32_t methods = 1 + next(3);
+        for (uint32_t i = 0; i < methods; ++i)
+        {
+            buffer += '\n';
+            function_declaration(1);
+        }
+        --indent_level;
+        buffer += "}\n";
+    }
+
+    void global_declaration()
+    {
+        comment();
+        variable(true);
+    }
+};
+
+/**
+ * @brief Generates a corpus of roughly the requested size with the default mix.
+ */
+inline std::string make_corpus(const size_t bytes, const uint64_t seed = corpus_options{}.seed)
+{
+    corpus_options options;
+    options.bytes = bytes;
+    options.seed = seed;
+    return CorpusGenerator(options).generate();
+}
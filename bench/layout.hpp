@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdio>
+#include "common.hpp"
+#include "../lang/include/lexer.h"
+
+template<typename Layout>
+void bench_layout(const char* name, const std::string& src, const nightglow::lang::memory::vector<nightglow::lang::token_t>& tokens)
+{
+    using namespace nightglow::lang;
+    const auto n = static_cast<double>(tokens.size());
+
+    const double lex = median_ns([&]
+    {
+        auto lexer = lexer::create_lexer<Layout>(src, src.size());
+        do_not_optimize(lexer::tokenize(lexer)->size());
+    });
+
+    const double push = median_ns([&]
+    {
+        BasicTokenList<Layout> list;
+        list.reserve(static_cast<uint32_t>(tokens.size()));
+        for (const token_t& token : tokens)
+        {
+            list.push_back(token);
+        }
+        do_not_optimize(list.size());
+    });
+
+    BasicTokenList<Layout> list;
+    for (const token_t& token : tokens)
+    {
+        list.push_back(token);
+    }
+
+    // brace matching only looks at types
+    const double scan = median_ns([&]
+    {
+        uint32_t depth = 0;
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            depth += list.type(i) == token_i::LEFT_BRACE;
+            depth -= list.type(i) == token_i::RIGHT_BRACE;
+        }
+        do_not_optimize(depth);
+    });
+
+    // a parser reads whole tokens, typically with one token of lookahead
+    const double parse = median_ns([&]
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i + 1 < list.size(); ++i)
+        {
+            if (list.type(i) == token_i::IDENTIFIER && list.type(i + 1) == token_i::LEFT_PAREN)
+            {
+                sum += list.start(i) + list.length(i);
+            }
+            else
+            {
+                const token_t token = list[i];
+                sum += token.flags + static_cast<uint8_t>(token.type);
+            }
+        }
+        do_not_optimize(sum);
+    });
+
+    std::printf("  %-8s %12.2f %12.2f %12.2f %12.2f\n", name, lex / n, push / n, scan / n, parse / n);
+}
+
+inline void layout_benchmarks(const std::string& src)
+{
+    using namespace nightglow::lang;
+
+    auto lexer = lexer::create_lexer<aos_layout>(src, src.size());
+    const memory::vector<token_t>& tokens = lexer::tokenize(lexer)->records;
+
+    std::printf("TokenList layouts (%zu tokens, ns/token)\n", tokens.size());
+    std::printf("  %-8s %12s %12s %12s %12s\n", "layout", "tokenize", "push_back", "type scan", "parse");
+    bench_layout<soa_layout>("soa", src, tokens);
+    bench_layout<aos_layout>("aos", src, tokens);
+    bench_layout<aosoa_layout>("aosoa", src, tokens);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+#include "common.hpp"
+#include "corpus.hpp"
+#include "../lang/include/lexer.h"
+
+/**
+ * @brief Repeats a fragment until the input reaches the requested size.
+ */
+inline std::string repeat_input(const std::string_view fragment, const size_t bytes)
+{
+    std::string src;
+    src.reserve(bytes + fragment.size());
+    while (src.size() < bytes)
+    {
+        src += fragment;
+    }
+    return src;
+}
+
+inline void report_lexer(const char* name, const std::string& src, const size_t tokens, const double ns)
+{
+    const double bytes = static_cast<double>(src.size());
+    const double cycles = cycles_per_ns();
+    char per_token[16] = "-";
+    char per_byte[16] = "-";
+    if (tokens > 1)
+        std::snprintf(per_token, sizeof(per_token), "%.2f", ns / static_cast<double>(tokens));
+    if (cycles > 0)
+        std::snprintf(per_byte, sizeof(per_byte), "%.2f", ns * cycles / bytes);
+    std::printf("  %-30s %10.1f %12s %12s %10zu\n", name, bytes / ns * 1e3, per_byte, per_token, tokens);
+}
+
+/**
+ * @brief Calls a single-token lexing function at every token of an input made of that token kind.
+ */
+template<typename LexFn>
+void bench_lex_fn(const char* name, const std::string& src, LexFn&& lex)
+{
+    using namespace nightglow::lang;
+    size_t tokens = 0;
+    const double ns = median_ns([&]
+    {
+        auto lexer = lexer::create_lexer(src, src.size());
+        tokens = 0;
+        while (lexer.current_pos < lexer.src_length)
+        {
+            lexer::skip_whitespace_comment(lexer, lexer.src, lexer.current_pos, lexer.src_length);
+            if (lexer.current_pos >= lexer.src_length)
+                break;
+            const token_t token = lex(static_cast<const lexer::LexerState&>(lexer));
+            lexer.current_pos += std::max<uint16_t>(token.length, 1);
+            ++tokens;
+        }
+        do_not_optimize(tokens);
+    });
+    report_lexer(name, src, tokens, ns);
+}
+
+inline void bench_skip(const char* name, const std::string& src)
+{
+    using namespace nightglow::lang;
+    const double ns = median_ns([&]
+    {
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::skip_whitespace_comment(lexer, lexer.src, lexer.current_pos, lexer.src_length);
+        do_not_optimize(lexer.current_pos);
+    });
+    report_lexer(name, src, 0, ns);
+}
+
+inline void bench_tokenize(const char* name, const std::string& src, const bool match_brackets = false, const bool keep_trivia = false)
+{
+    using namespace nightglow::lang;
+    size_t tokens = 0;
+    const double ns = median_ns([&]
+    {
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer.match_brackets = match_brackets;
+        lexer.keep_trivia = keep_trivia;
+        tokens = lexer::tokenize(lexer)->size();
+        do_not_optimize(tokens);
+    });
+    report_lexer(name, src, tokens, ns);
+}
+
+inline void lexer_benchmarks(const size_t bytes)
+{
+    using namespace nightglow::lang;
+
+    const std::string whitespace = repeat_input("    \t  \n        \r\n", bytes);
+    const std::string comments = repeat_input("// a line comment explaining things\n/* a block comment */\n", bytes);
+    const std::string identifiers = repeat_input("alpha beta_2 gamma_delta epsilon x y z value_of_thing ", bytes);
+    const std::string numbers = repeat_input("12345 0x1F2E 3.14159 0b101101 42 7 1000000 ", bytes);
+    const std::string strings = repeat_input(R"("hello" "a \"quoted\" word" "" "path\\to\\file" )", bytes);
+    const std::string operators = repeat_input("+= -> << >>= == != && || <= >= ( ) { } [ ] ; , . ", bytes);
+    const std::string mixed = make_source(bytes);
+    const std::string corpus = make_corpus(bytes);
+
+    std::printf("Lexer (%zu byte inputs)\n", bytes);
+    std::printf("  %-30s %10s %12s %12s %10s\n", "benchmark", "MB/s", "cycles/byte", "ns/token", "tokens");
+    bench_skip("skip_whitespace_comment/ws", whitespace);
+    bench_skip("skip_whitespace_comment/cmt", comments);
+    bench_lex_fn("lex_identifier", identifiers, lexer::lex_identifier);
+    bench_lex_fn("lex_number", numbers, lexer::lex_number);
+    bench_lex_fn("lex_string", strings, lexer::lex_string);
+    bench_lex_fn("operators (next_token)", operators, [](const lexer::LexerState& lexer)
+    {
+        return lexer::next_token(const_cast<lexer::LexerState&>(lexer));
+    });
+    bench_tokenize("tokenize/whitespace-heavy", whitespace);
+    bench_tokenize("tokenize/comment-heavy", comments);
+    bench_tokenize("tokenize/identifier-heavy", identifiers);
+    bench_tokenize("tokenize/numeric-heavy", numbers);
+    bench_tokenize("tokenize/operator-heavy", operators);
+    bench_tokenize("tokenize/mixed", mixed);
+    bench_tokenize("tokenize/corpus", corpus);
+    bench_tokenize("tokenize/corpus, brackets", corpus, true);
+    bench_tokenize("tokenize/corpus, trivia", corpus, false, true);
+}
@@ -0,0 +1,74 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "layout.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "perf.hpp"
+#include "pipeline.hpp"
+#include "regression.hpp"
+
+int main(const int argc, char** argv)
+{
+    size_t bytes = 8u << 20;
+    auto count_events = false;
+    std::string baseline_path;
+    std::string write_path;
+    auto tolerance = 10.0;
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--perf")
+            count_events = true;
+        else if (arg.starts_with("--check="))
+            baseline_path = arg.substr(std::string_view("--check=").size());
+        else if (arg.starts_with("--write-baseline="))
+            write_path = arg.substr(std::string_view("--write-baseline=").size());
+        else if (arg.starts_with("--tolerance="))
+            tolerance = std::strtod(argv[i] + std::string_view("--tolerance=").size(), nullptr);
+        else
+            bytes = std::strtoull(argv[i], nullptr, 10);
+    }
+
+    if (!write_path.empty())
+    {
+        if (!write_baseline(write_path, run_regression_suite()))
+        {
+            std::cerr << "nightglow-bench: cannot write " << write_path << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!baseline_path.empty())
+    {
+        const auto baseline = read_baseline(baseline_path);
+        if (!baseline)
+        {
+            std::cerr << "nightglow-bench: cannot read baseline " << baseline_path << " (missing, malformed or for a different input size)\n";
+            return 1;
+        }
+        std::printf("Perf regression check against %s (tolerance %.1f%%)\n", baseline_path.c_str(), tolerance);
+        return check_regressions(*baseline, run_regression_suite(), tolerance) ? 0 : 1;
+    }
+
+    if (count_events)
+    {
+        perf_benchmarks(bytes);
+        return 0;
+    }
+
+    const std::string src = make_source(bytes);
+
+    lexer_benchmarks(bytes);
+    parser_benchmarks(bytes);
+    layout_benchmarks(src);
+    pipeline_benchmarks(src);
+    return 0;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdio>
+#include "common.hpp"
+#include "corpus.hpp"
+#include "../lang/include/incremental.h"
+#include "../lang/include/precompiled.h"
+
+/**
+ * @brief Times a parse and returns its time per token. Given the time per token of another row, also prints how much
+ * slower or faster this one is.
+ */
+inline double bench_parse(const char* name, const nightglow::lang::lexer::Lexer& lexer, const nightglow::lang::parser::parse_options& options,
+                          const double against = 0.0)
+{
+    using namespace nightglow::lang;
+    uint32_t nodes = 0;
+    const double ns = median_ns([&]
+    {
+        const ast::Ast tree = parser::parse(lexer, options);
+        nodes = tree.size();
+        do_not_optimize(nodes);
+    });
+    const double bytes = static_cast<double>(lexer.src_length);
+    const double per_token = ns / static_cast<double>(lexer.tokens.size());
+    std::printf("  %-30s %10.1f %12.2f %12u", name, bytes / ns * 1e3, per_token, nodes);
+    if (against > 0.0)
+        std::printf("   %+.1f%% per token", (per_token / against - 1.0) * 100.0);
+    std::printf("\n");
+    return per_token;
+}
+
+/**
+ * @brief Times one way of getting the interface of a module; the last column is the number of declarations.
+ */
+template<typename Fn>
+void bench_interface(const char* name, const nightglow::lang::lexer::Lexer& lexer, Fn&& fn)
+{
+    size_t decls = 0;
+    const double ns = median_ns([&]
+    {
+        decls = fn().decls.size();
+        do_not_optimize(decls);
+    });
+    const double bytes = static_cast<double>(lexer.src_length);
+    std::printf("  %-30s %10.1f %12.2f %12zu\n", name, bytes / ns * 1e3, ns / static_cast<double>(lexer.tokens.size()), decls);
+}
+
+/**
+ * @brief Times one-character edits at the first statement end past an offset of a corpus, each undone by the next. A
+ * sample is a run of edits long enough to include applying the pending token shifts to the tree, so the time is
+ * what an edit costs on average.
+ */
+inline void bench_edits(const size_t bytes, const size_t offset)
+{
+    using namespace nightglow::lang;
+    constexpr int edits = 1024;
+    auto document = incremental::open_document(make_corpus(bytes));
+    const auto at = static_cast<uint32_t>(document.text.find(';', offset));
+    const double tokens = static_cast<double>(document.lexer.tokens.size());
+    uint32_t reparsed = 0;
+    auto flip = false;
+    const double ns = median_ns([&]
+    {
+        for (auto i = 0; i < edits; ++i)
+        {
+            flip = !flip;
+            reparsed = incremental::apply_edit(document, flip ? incremental::text_edit{ at, 0, " + 1" } : incremental::text_edit{ at, 4, "" }).reparsed_tokens;
+            do_not_optimize(reparsed);
+        }
+    }, 5) / edits;
+    char name[48];
+    std::snprintf(name, sizeof(name), "parse/edit, %zu KiB corpus", bytes >> 10);
+    std::printf("  %-30s %10s %12.2f %12s   %.1f us per edit, %u tokens reparsed\n", name, "-", ns / tokens, "-", ns / 1e3, reparsed);
+}
+
+inline void parser_benchmarks(const size_t bytes)
+{
+    using namespace nightglow::lang;
+
+    const std::string corpus = make_corpus(bytes);
+    auto lexer = lexer::create_lexer(corpus, corpus.size());
+    lexer::tokenize(lexer);
+
+    std::printf("Parser (%zu byte corpus, %zu tokens)\n", bytes, lexer.tokens.size());
+    std::printf("  %-30s %10s %12s %12s\n", "benchmark", "MB/s", "ns/token", "nodes");
+    bench_parse("parse/eager", lexer, {});
+    bench_parse("parse/lazy bodies", lexer, { .lazy_bodies = true });
+    bench_parse("parse/all threads", lexer, { .threads = 0 });
+
+    lexer.match_brackets = true;
+    lexer::reset_lexer(lexer, corpus, corpus.size());
+    lexer::tokenize(lexer);
+    bench_parse("parse/lazy bodies, matched", lexer, { .lazy_bodies = true });
+    bench_interface("interface/lazy parse + extract", lexer, [&lexer]
+    {
+        return precompiled::extract(lexer, parser::parse(lexer, { .lazy_bodies = true }));
+    });
+    bench_interface("interface/scan, matched", lexer, [&lexer] { return precompiled::scan(lexer); });
+
+    // every eighth statement loses an operand. Rows further down run with the allocator and caches warmer than the
+    // first, so the clean corpus is parsed again right before for the two to compare
+    std::string broken = corpus;
+    for (size_t i = broken.find(';'), n = 0; i != std::string::npos; i = broken.find(';', i + 3), ++n)
+    {
+        if (n % 8 == 0)
+            broken.replace(i, 1, " +;");
+    }
+    auto broken_lexer = lexer::create_lexer(broken, broken.size());
+    lexer::tokenize(broken_lexer);
+    const double clean = bench_parse("parse/eager, again", lexer, {});
+    bench_parse("parse/eager, 1 in 8 broken", broken_lexer, {}, clean);
+
+    // the same edit on corpora of a quarter, half and all of the size, which share their beginning: the cost of an
+    // edit should not follow the size of the file
+    for (const size_t size : { bytes / 4, bytes / 2, bytes })
+    {
+        bench_edits(size, bytes / 8);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iostream>
+#include "corpus.hpp"
+#include "lexer.hpp"
+#include "../lang/include/perf.h"
+
+inline void perf_skip(nightglow::lang::perf::Counters& counters, const char* name, const std::string& src)
+{
+    using namespace nightglow::lang;
+    auto lexer = lexer::create_lexer(src, src.size());
+    counters.start();
+    lexer::skip_whitespace_comment(lexer, lexer.src, lexer.current_pos, lexer.src_length);
+    const perf::counts c = counters.stop();
+    do_not_optimize(lexer.current_pos);
+    perf::print_report(std::cout, name, c, src.size(), 0);
+}
+
+inline void perf_tokenize(nightglow::lang::perf::Counters& counters, const char* name, const std::string& src)
+{
+    using namespace nightglow::lang;
+    auto lexer = lexer::create_lexer(src, src.size());
+    counters.start();
+    const size_t tokens = lexer::tokenize(lexer)->size();
+    const perf::counts c = counters.stop();
+    perf::print_report(std::cout, name, c, src.size(), tokens);
+}
+
+inline void perf_benchmarks(const size_t bytes)
+{
+    using namespace nightglow::lang;
+    perf::Counters counters;
+    if (!counters.available())
+    {
+        std::cout << "Hardware counters unavailable (" << counters.error << ")\n";
+        return;
+    }
+
+    std::cout << "Hardware counters (" << bytes << " byte inputs)\n";
+    perf_skip(counters, "skip_whitespace_comment/ws", repeat_input("    \t  \n        \r\n", bytes));
+    perf_skip(counters, "skip_whitespace_comment/cmt", repeat_input("// a line comment explaining things\n/* a block comment */\n", bytes));
+    perf_tokenize(counters, "tokenize/identifier-heavy", repeat_input("alpha beta_2 gamma_delta epsilon x y z value_of_thing ", bytes));
+    perf_tokenize(counters, "tokenize/corpus", make_corpus(bytes));
+}
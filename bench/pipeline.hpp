@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdio>
+#include "common.hpp"
+#include "../lang/include/pipeline.h"
+
+inline void pipeline_benchmarks(const std::string& src)
+{
+    using namespace nightglow::lang;
+
+    // stands in for a parser: touches every field of every token
+    const auto visit = [](const token_t& token, uint64_t& sum)
+    {
+        sum = sum * 31 + token.start + token.length + static_cast<uint8_t>(token.type);
+    };
+
+    size_t count = 0;
+    const double serial = median_ns([&]
+    {
+        auto lexer = lexer::create_lexer(src, src.size());
+        const TokenList* tokens = lexer::tokenize(lexer);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < tokens->size(); ++i)
+        {
+            visit((*tokens)[i], sum);
+        }
+        count = tokens->size();
+        do_not_optimize(sum);
+    }, 7);
+
+    const double pipelined = median_ns([&]
+    {
+        auto lexer = lexer::create_lexer(src, src.size());
+        uint64_t sum = 0;
+        pipeline::run(lexer, [&](const pipeline::token_batch& batch)
+        {
+            for (uint32_t i = 0; i < batch.size; ++i)
+            {
+                visit(batch.tokens[i], sum);
+            }
+        });
+        do_not_optimize(sum);
+    }, 7);
+
+    std::printf("Lexer pipeline (%zu tokens, ms)\n", count);
+    std::printf("  %-12s %10.2f\n", "serial", serial / 1e6);
+    std::printf("  %-12s %10.2f\n", "pipelined", pipelined / 1e6);
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "allocations.hpp"
+#include "corpus.hpp"
+#include "lexer.hpp"
+
+/**
+ * @brief Size of every input in the regression suite. Fixed so that baselines stay comparable.
+ */
+inline constexpr size_t regression_bytes = 4u << 20;
+
+inline constexpr int regression_repetitions = 21;
+
+/**
+ * @brief Median throughput, its noise and the allocation count of one benchmark.
+ */
+struct regression_result
+{
+    std::string name;
+    double mb_per_s;
+    double mad_percent;
+    uint64_t allocations;
+};
+
+/**
+ * @brief Times fn and reports the median throughput with the median absolute deviation as a percentage of it.
+ */
+template<typename Fn>
+regression_result measure_regression(const std::string& name, const size_t bytes, Fn&& fn)
+{
+    fn(); // warm up caches and the allocator
+    const uint64_t allocations = count_allocations(fn);
+
+    std::vector<double> rates;
+    for (auto i = 0; i < regression_repetitions; ++i)
+    {
+        const double ns = median_ns(fn, 1);
+        rates.push_back(static_cast<double>(bytes) / ns * 1e3);
+    }
+    std::ranges::sort(rates);
+    const double median = rates[rates.size() / 2];
+
+    std::vector<double> deviations;
+    for (const double rate : rates)
+    {
+        deviations.push_back(std::abs(rate - median));
+    }
+    std::ranges::sort(deviations);
+    return { name, median, deviations[deviations.size() / 2] / median * 100.0, allocations };
+}
+
+inline std::vector<regression_result> run_regression_suite()
+{
+    using namespace nightglow::lang;
+    const auto tokenize = [](const std::string& src)
+    {
+        return [&src]
+        {
+            auto lexer = lexer::create_lexer(src, src.size());
+            do_not_optimize(lexer::tokenize(lexer)->size());
+        };
+    };
+
+    const std::string corpus = make_corpus(regression_bytes);
+    const std::string identifiers = repeat_input("alpha beta_2 gamma_delta epsilon x y z value_of_thing ", regression_bytes);
+    const std::string numbers = repeat_input("12345 0x1F2E 3.14159 0b101101 42 7 1000000 ", regression_bytes);
+    const std::string comments = repeat_input("// a line comment explaining things\n/* a block comment */\n", regression_bytes);
+
+    std::vector<regression_result> results;
+    results.push_back(measure_regression("tokenize/corpus", corpus.size(), tokenize(corpus)));
+    results.push_back(measure_regression("tokenize/identifier-heavy", identifiers.size(), tokenize(identifiers)));
+    results.push_back(measure_regression("tokenize/numeric-heavy", numbers.size(), tokenize(numbers)));
+    results.push_back(measure_regression("tokenize/comment-heavy", comments.size(), tokenize(comments)));
+    return results;
+}
+
+inline bool write_baseline(const std::string& path, const std::vector<regression_result>& results)
+{
+    std::ofstream out(path);
+    out << "{\n  \"input_bytes\": " << regression_bytes << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        char line[256];
+        std::snprintf(line, sizeof(line), R"(    { "name": "%s", "mb_per_s": %.2f, "mad_percent": %.2f, "allocations": %llu })",
+                      results[i].name.c_str(), results[i].mb_per_s, results[i].mad_percent, static_cast<unsigned long long>(results[i].allocations));
+        out << line << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+namespace regression_detail
+{
+    inline std::optional<double> number_field(const std::string_view object, const std::string_view key)
+    {
+        const auto at = object.find("\"" + std::string(key) + "\"");
+        if (at == std::string_view::npos)
+            return std::nullopt;
+        const auto colon = object.find(':', at);
+        if (colon == std::string_view::npos)
+            return std::nullopt;
+        return std::strtod(std::string(object.substr(colon + 1, 32)).c_str(), nullptr);
+    }
+
+    inline std::optional<std::string> string_field(const std::string_view object, const std::string_view key)
+    {
+        const auto at = object.find("\"" + std::string(key) + "\"");
+        if (at == std::string_view::npos)
+            return std::nullopt;
+        const auto open = object.find('"', object.find(':', at));
+        const auto close = object.find('"', open + 1);
+        if (open == std::string_view::npos || close == std::string_view::npos)
+            return std::nullopt;
+        return std::string(object.substr(open + 1, close - open - 1));
+    }
+}
+
+/**
+ * @brief Reads a baseline written by write_baseline(). Only understands that flat layout, one object per benchmark.
+ */
+inline std::optional<std::vector<regression_result>> read_baseline(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+        return std::nullopt;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    if (const auto bytes = regression_detail::number_field(text, "input_bytes"); !bytes || *bytes != regression_bytes)
+        return std::nullopt;
+
+    std::vector<regression_result> results;
+    for (size_t begin = text.find('{', text.find("\"benchmarks\"")); begin != std::string::npos; begin = text.find('{', begin + 1))
+    {
+        const size_t end = text.find('}', begin);
+        if (end == std::string::npos)
+            return std::nullopt;
+        const std::string_view object(text.data() + begin, end - begin);
+        const auto name = regression_detail::string_field(object, "name");
+        const auto rate = regression_detail::number_field(object, "mb_per_s");
+        const auto mad = regression_detail::number_field(object, "mad_percent");
+        const auto allocations = regression_detail::number_field(object, "allocations");
+        if (!name || !rate || !mad || !allocations)
+            return std::nullopt;
+        results.push_back({ *name, *rate, *mad, static_cast<uint64_t>(*allocations) });
+    }
+    return results;
+}
+
+/**
+ * @brief Compares a run against the baseline and prints a diff table.
+ * A benchmark regresses if its throughput drops by more than the larger of the tolerance and three times
+ * the noise (MAD) of either run, or if it allocates more often than the baseline did.
+ * @return bool True if nothing regressed.
+ */
+inline bool check_regressions(const std::vector<regression_result>& baseline, const std::vector<regression_result>& current, const double tolerance_percent)
+{
+    std::printf("%-28s %12s %12s %9s %9s %17s  %s\n", "benchmark", "base MB/s", "now MB/s", "change", "limit", "allocs base/now", "status");
+    auto passed = true;
+    for (const regression_result& now : current)
+    {
+        const auto base = std::ranges::find(baseline, now.name, &regression_result::name);
+        if (base == baseline.end())
+        {
+            std::printf("%-28s %12s %12.1f %9s %9s %17s  new (not in baseline)\n", now.name.c_str(), "-", now.mb_per_s, "-", "-", "-");
+            continue;
+        }
+
+        const double change = (now.mb_per_s - base->mb_per_s) / base->mb_per_s * 100.0;
+        const double limit = std::max(tolerance_percent, 3.0 * std::max(base->mad_percent, now.mad_percent));
+        const bool slower = change < -limit;
+        const bool more_allocations = now.allocations > base->allocations;
+        passed = passed && !slower && !more_allocations;
+
+        char allocs[40];
+        std::snprintf(allocs, sizeof(allocs), "%llu/%llu", static_cast<unsigned long long>(base->allocations), static_cast<unsigned long long>(now.allocations));
+        std::printf("%-28s %12.1f %12.1f %+8.1f%% %+8.1f%% %17s  %s\n", now.name.c_str(), base->mb_per_s, now.mb_per_s, change, -limit, allocs,
+                    slower && more_allocations ? "REGRESSED (throughput, allocations)"
+                    : slower ? "REGRESSED (throughput)"
+                    : more_allocations ? "REGRESSED (allocations)" : "ok");
+    }
+    return passed;
+}
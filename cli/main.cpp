@@ -3,13 +3,95 @@
 // This header file is a part of the Nightglow programming language, licensed under the MIT license.
 //
 
-#include <cassert>
-#include <chrono>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
 
-#include "../lang/include/lexer.h"
+#include "src/commands.h"
+#include "trace.h"
 
-int main()
+namespace
 {
-    return 0;
-}
\ No newline at end of file
+    void print_usage()
+    {
+        std::cerr <<
+            "usage: Nightglow <command> [options]\n"
+            "\n"
+            "commands:\n"
+            "  build    run the frontend over a module graph in parallel\n"
+            "  lex      tokenize files and report lexer throughput\n"
+            "  daemon   serve requests over a Unix socket with warm caches\n"
+            "  request  send a request to a running daemon\n"
+            "  watch    re-lex files under directories as they change\n"
+            "\n"
+            "options accepted by every command:\n"
+            "  --time-trace[=<file>]  write a Chrome/Perfetto trace (default nightglow-trace.json)\n"
+            "  --time-passes          print time spent per phase\n";
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        print_usage();
+        return 2;
+    }
+
+    const std::string command = argv[1];
+    std::vector<std::string> args;
+    std::string trace_path;
+    auto time_passes = false;
+    for (auto i = 2; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--time-trace")
+            trace_path = "nightglow-trace.json";
+        else if (arg.starts_with("--time-trace="))
+            trace_path = arg.substr(std::string_view("--time-trace=").size());
+        else if (arg == "--time-passes")
+            time_passes = true;
+        else
+            args.emplace_back(arg);
+    }
+
+    if (!trace_path.empty() || time_passes)
+    {
+        #ifdef NIGHTGLOW_TRACE
+        nightglow::lang::trace::enable();
+        #else
+        std::cerr << "Nightglow: built without NIGHTGLOW_TRACE, --time-trace and --time-passes are ignored\n";
+        #endif
+    }
+
+    auto status = 2;
+    if (command == "build")
+        status = nightglow::cli::build_command(args);
+    else if (command == "lex")
+        status = nightglow::cli::lex_command(args);
+    else if (command == "daemon")
+        status = nightglow::cli::daemon_command(args);
+    else if (command == "request")
+        status = nightglow::cli::request_command(args);
+    else if (command == "watch")
+        status = nightglow::cli::watch_command(args);
+    else
+    {
+        if (command != "-h" && command != "--help")
+            std::cerr << "Nightglow: unknown command '" << command << "'\n";
+        print_usage();
+        return command == "-h" || command == "--help" ? 0 : 2;
+    }
+
+    #ifdef NIGHTGLOW_TRACE
+    if (time_passes)
+        nightglow::lang::trace::print_time_passes(std::cerr);
+    if (!trace_path.empty() && !nightglow::lang::trace::write_chrome_trace(trace_path))
+    {
+        std::cerr << "Nightglow: cannot write trace to " << trace_path << "\n";
+        return 1;
+    }
+    #endif
+    return status;
+}
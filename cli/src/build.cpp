@@ -0,0 +1,347 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "commands.h"
+#include "common.h"
+#include "imports.h"
+#include "lexer.h"
+#include "parser.h"
+#include "precompiled.h"
+#include "trace.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    using namespace nightglow;
+    using clock_type = std::chrono::steady_clock;
+
+    struct module_job
+    {
+        std::string name;
+        std::filesystem::path path;
+        std::string src;
+        std::vector<uint32_t> dependents;
+        uint32_t pending{};
+        uint64_t cost{};
+        uint64_t critical_path{};
+        uint64_t tokens{};
+        uint64_t declarations{};
+        std::chrono::nanoseconds duration{};
+        bool failed{};
+    };
+
+    /**
+     * @brief Maps a file to its module name: the path relative to its root, without extension, with '/' replaced by '.'.
+     */
+    std::string module_name(const std::filesystem::path& root, const std::filesystem::path& file)
+    {
+        const std::filesystem::path base = std::filesystem::is_directory(root) ? root : root.parent_path();
+        std::filesystem::path relative = file.lexically_relative(base);
+        relative.replace_extension();
+
+        std::string name;
+        for (const auto& part : relative)
+        {
+            name += (name.empty() ? "" : ".") + part.string();
+        }
+        return name;
+    }
+
+    /**
+     * @brief Runs the frontend for one module: lexing, then the interface scan. With an interface directory, the
+     * interface is written there as a module file, where precompiled::load() finds it for dependents by the source.
+     * A module with unmatched brackets fails; before writing, the module is also parsed with lazy bodies, and one
+     * with syntax errors fails unwritten, like precompiled::store(), so a stale interface is never taken for a good one.
+     */
+    void run_job(module_job& job, const std::filesystem::path& interfaces)
+    {
+        NIGHTGLOW_TRACE_SCOPE("module", job.name);
+        const auto begin = clock_type::now();
+        // workers share stderr, so each module's diagnostics go out in one write
+        std::string report;
+        try
+        {
+            auto lexer = lang::lexer::create_lexer(job.src, job.src.size());
+            lexer.match_brackets = true;
+            const lang::TokenList* tokens = lang::lexer::tokenize(lexer);
+            job.tokens = tokens->size();
+            for (const uint32_t i : tokens->unmatched)
+            {
+                const lang::token_t token = (*tokens)[i];
+                const auto [line, col] = lang::lexer::get_line_col(lexer, token);
+                report += "Nightglow build: " + job.path.string() + ":" + std::to_string(line) + ":" + std::to_string(col) + ": unmatched '"
+                    + std::string(lang::lexer::get_token_value(lexer, token)) + "'\n";
+            }
+            const lang::precompiled::Interface exported = lang::precompiled::scan(lexer);
+            job.declarations = exported.decls.size();
+            if (!interfaces.empty() && report.empty())
+            {
+                const lang::ast::Ast tree = lang::parser::parse(lexer, { .lazy_bodies = true });
+                for (size_t i = 0; i < tree.errors.size(); ++i)
+                {
+                    report += "Nightglow build: " + job.path.string() + ":" + lang::parser::format_error(lexer, tree.errors[i]) + "\n";
+                }
+                if (report.empty() && !lang::precompiled::write(lang::precompiled::module_path(interfaces, job.src), exported, job.src))
+                    throw std::runtime_error("cannot write its interface to " + interfaces.string());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            report += "Nightglow build: " + job.path.string() + ": " + e.what() + "\n";
+        }
+        if (!report.empty())
+        {
+            std::cerr << report;
+            job.failed = true;
+        }
+        job.duration = clock_type::now() - begin;
+    }
+}
+
+int nightglow::cli::build_command(const std::span<const std::string> args)
+{
+    uint32_t workers = std::max(1u, std::thread::hardware_concurrency());
+    std::string extension(source_extension);
+    std::filesystem::path interfaces;
+    std::vector<std::string> roots;
+
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const std::string& arg = args[i];
+        if ((arg == "-j" && i + 1 < args.size()) || (arg.starts_with("-j") && arg.size() > 2))
+        {
+            const std::string_view count = arg == "-j" ? std::string_view(args[++i]) : std::string_view(arg).substr(2);
+            const std::optional<uint32_t> parsed = parse_number(count);
+            if (!parsed)
+            {
+                std::cerr << "Nightglow build: -j expects a number, got '" << count << "'\n";
+                return 2;
+            }
+            workers = std::max(1u, *parsed);
+        }
+        else if (arg == "--ext" && i + 1 < args.size())
+            extension = args[++i];
+        else if (arg == "-o" && i + 1 < args.size())
+            interfaces = args[++i];
+        else if (arg.starts_with("-"))
+        {
+            std::cerr << "Nightglow build: unknown option '" << arg << "'\n";
+            return 2;
+        }
+        else
+            roots.push_back(arg);
+    }
+    if (roots.empty())
+    {
+        std::cerr << "usage: Nightglow build [-j N] [--ext <ext>] [-o <interface dir>] <dir|file>...\n";
+        return 2;
+    }
+    if (!interfaces.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(interfaces, ec);
+        if (ec)
+        {
+            std::cerr << "Nightglow build: cannot create " << interfaces.string() << ": " << ec.message() << "\n";
+            return 1;
+        }
+    }
+
+    // discover modules and pre-scan their imports
+    const auto build_begin = clock_type::now();
+    std::vector<module_job> jobs;
+    std::unordered_map<std::string, uint32_t> by_name;
+    try
+    {
+        for (const std::string& root : roots)
+        {
+            for (const std::filesystem::path& file : collect_sources(std::span(&root, 1), extension))
+            {
+                std::optional<std::string> src = read_file(file);
+                if (!src)
+                {
+                    std::cerr << "Nightglow build: cannot read " << file.string() << "\n";
+                    return 1;
+                }
+
+                module_job job;
+                job.name = module_name(root, file);
+                job.path = file;
+                job.src = std::move(*src);
+                job.cost = std::max<uint64_t>(job.src.size(), 1);
+                if (!by_name.emplace(job.name, static_cast<uint32_t>(jobs.size())).second)
+                {
+                    std::cerr << "Nightglow build: duplicate module '" << job.name << "' (" << file.string() << ")\n";
+                    return 1;
+                }
+                jobs.push_back(std::move(job));
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Nightglow build: " << e.what() << "\n";
+        return 1;
+    }
+
+    size_t external = 0;
+    for (uint32_t i = 0; i < jobs.size(); ++i)
+    {
+        // a module whose imports cannot be scanned fails on its own; the rest of the build goes on without its edges
+        lang::memory::vector<lang::import_decl> imports;
+        try
+        {
+            imports = lang::scan_imports(jobs[i].src);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Nightglow build: " << jobs[i].path.string() << ": " << e.what() << "\n";
+            jobs[i].failed = true;
+        }
+        for (const lang::import_decl& decl : imports)
+        {
+            if (const auto it = by_name.find(decl.module); it != by_name.end() && it->second != i)
+            {
+                jobs[it->second].dependents.push_back(i);
+                ++jobs[i].pending;
+            }
+            else if (it == by_name.end())
+            {
+                ++external;
+            }
+        }
+    }
+    const auto scan_end = clock_type::now();
+
+    // topological order (Kahn), then critical path = own cost + longest path through dependents
+    std::vector<uint32_t> order;
+    order.reserve(jobs.size());
+    {
+        std::vector<uint32_t> pending(jobs.size());
+        for (uint32_t i = 0; i < jobs.size(); ++i)
+        {
+            pending[i] = jobs[i].pending;
+            if (pending[i] == 0)
+                order.push_back(i);
+        }
+        for (size_t head = 0; head < order.size(); ++head)
+        {
+            for (const uint32_t dependent : jobs[order[head]].dependents)
+            {
+                if (--pending[dependent] == 0)
+                    order.push_back(dependent);
+            }
+        }
+        if (order.size() != jobs.size())
+        {
+            std::cerr << "Nightglow build: import cycle between:";
+            for (uint32_t i = 0; i < jobs.size(); ++i)
+            {
+                if (pending[i] != 0)
+                    std::cerr << " " << jobs[i].name;
+            }
+            std::cerr << "\n";
+            return 1;
+        }
+    }
+
+    uint64_t total_cost = 0;
+    uint64_t longest = 0;
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        module_job& job = jobs[*it];
+        uint64_t tail = 0;
+        for (const uint32_t dependent : job.dependents)
+        {
+            tail = std::max(tail, jobs[dependent].critical_path);
+        }
+        job.critical_path = job.cost + tail;
+        total_cost += job.cost;
+        longest = std::max(longest, job.critical_path);
+    }
+
+    // ready modules are started longest-critical-path first
+    const auto by_priority = [&jobs](const uint32_t a, const uint32_t b) { return jobs[a].critical_path < jobs[b].critical_path; };
+    std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(by_priority)> ready(by_priority);
+    for (uint32_t i = 0; i < jobs.size(); ++i)
+    {
+        if (jobs[i].pending == 0)
+            ready.push(i);
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t remaining = jobs.size();
+    auto failed = false;
+
+    const auto worker = [&](const uint32_t id)
+    {
+        lang::trace::set_thread_name("worker " + std::to_string(id));
+        std::unique_lock lock(mutex);
+        while (true)
+        {
+            cv.wait(lock, [&] { return !ready.empty() || remaining == 0; });
+            if (remaining == 0)
+                return;
+
+            const uint32_t index = ready.top();
+            ready.pop();
+            lock.unlock();
+            if (!jobs[index].failed)
+                run_job(jobs[index], interfaces);
+            lock.lock();
+
+            failed = failed || jobs[index].failed;
+            --remaining;
+            for (const uint32_t dependent : jobs[index].dependents)
+            {
+                if (--jobs[dependent].pending == 0)
+                    ready.push(dependent);
+            }
+            cv.notify_all();
+        }
+    };
+
+    const auto run_begin = clock_type::now();
+    {
+        std::vector<std::jthread> pool;
+        for (uint32_t id = 0; id < workers; ++id)
+        {
+            pool.emplace_back(worker, id);
+        }
+    }
+    const auto run_end = clock_type::now();
+
+    std::chrono::nanoseconds busy{};
+    uint64_t tokens = 0;
+    uint64_t declarations = 0;
+    for (const module_job& job : jobs)
+    {
+        busy += job.duration;
+        tokens += job.tokens;
+        declarations += job.declarations;
+    }
+
+    const auto ms = [](const std::chrono::nanoseconds d) { return std::chrono::duration<double, std::milli>(d).count(); };
+    const double run_ms = ms(run_end - run_begin);
+    std::fprintf(stderr, "modules      %zu (%zu external imports)\n", jobs.size(), external);
+    std::fprintf(stderr, "tokens       %llu\n", static_cast<unsigned long long>(tokens));
+    std::fprintf(stderr, "declarations %llu\n", static_cast<unsigned long long>(declarations));
+    if (!interfaces.empty())
+        std::fprintf(stderr, "interfaces   written to %s\n", interfaces.string().c_str());
+    std::fprintf(stderr, "scan         %.3f ms\n", ms(scan_end - build_begin));
+    std::fprintf(stderr, "frontend     %.3f ms on %u workers\n", run_ms, workers);
+    std::fprintf(stderr, "parallelism  %.2f achieved, %.2f available (total cost / critical path)\n",
+                 run_ms > 0 ? ms(busy) / run_ms : 0.0, longest > 0 ? static_cast<double>(total_cost) / static_cast<double>(longest) : 0.0);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,51 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef CLI_COMMANDS_H
+#define CLI_COMMANDS_H
+
+#include <span>
+#include <string>
+
+namespace nightglow::cli
+{
+    /**
+     * @brief `Nightglow lex`: tokenizes files and directories and reports lexer throughput.
+     * @param args The arguments after the subcommand name.
+     * @return int The process exit code.
+     */
+    int lex_command(std::span<const std::string> args);
+
+    /**
+     * @brief `Nightglow daemon`: serves requests over a Unix domain socket, keeping token streams resident between them.
+     * @param args The arguments after the subcommand name.
+     * @return int The process exit code.
+     */
+    int daemon_command(std::span<const std::string> args);
+
+    /**
+     * @brief `Nightglow request`: thin client that sends one request to a running daemon and prints the response.
+     * @param args The arguments after the subcommand name.
+     * @return int The process exit code.
+     */
+    int request_command(std::span<const std::string> args);
+
+    /**
+     * @brief `Nightglow watch`: re-lexes files under the given directories as they change, using inotify.
+     * @param args The arguments after the subcommand name.
+     * @return int The process exit code.
+     */
+    int watch_command(std::span<const std::string> args);
+
+    /**
+     * @brief `Nightglow build`: runs the frontend over a module graph in import order on a pool of workers, and with
+     * -o writes the interface of every module to a directory.
+     * @param args The arguments after the subcommand name.
+     * @return int The process exit code.
+     */
+    int build_command(std::span<const std::string> args);
+}
+
+#endif
@@ -0,0 +1,109 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "common.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+std::optional<std::string> nightglow::cli::read_file(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        return std::nullopt;
+    }
+
+    std::string contents(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!in.read(contents.data(), static_cast<std::streamsize>(contents.size())))
+    {
+        return std::nullopt;
+    }
+    return contents;
+}
+
+std::vector<std::filesystem::path> nightglow::cli::collect_sources(const std::span<const std::string> paths, const std::string_view extension)
+{
+    std::vector<std::filesystem::path> sources;
+    for (const std::string& arg : paths)
+    {
+        const std::filesystem::path path(arg);
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == extension)
+                {
+                    sources.push_back(entry.path());
+                }
+            }
+        }
+        else if (std::filesystem::exists(path))
+        {
+            sources.push_back(path);
+        }
+        else
+        {
+            throw std::runtime_error("No such file or directory: " + arg);
+        }
+    }
+
+    std::ranges::sort(sources);
+    return sources;
+}
+
+uint64_t nightglow::cli::peak_rss_bytes()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+    #else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    #endif
+}
+
+std::string nightglow::cli::default_socket_path()
+{
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime)
+    {
+        return (std::filesystem::path(runtime) / "nightglow.sock").string();
+    }
+    return "/tmp/nightglow-" + std::to_string(getuid()) + ".sock";
+}
+
+std::optional<uint32_t> nightglow::cli::parse_number(const std::string_view text)
+{
+    uint32_t value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || end != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::string nightglow::cli::format_bytes(const uint64_t bytes)
+{
+    constexpr const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+    auto value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < std::size(units))
+    {
+        value /= 1024.0;
+        ++unit;
+    }
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.1f %s", value, units[unit]);
+    return buffer;
+}
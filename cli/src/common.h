@@ -0,0 +1,64 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef CLI_COMMON_H
+#define CLI_COMMON_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nightglow::cli
+{
+    /**
+     * @brief File extension of Nightglow sources, used when walking directories.
+     */
+    inline constexpr std::string_view source_extension = ".ng";
+
+    /**
+     * @brief Reads a whole file into memory.
+     * @param path The file to read.
+     * @return std::optional<std::string> The contents, or std::nullopt if the file cannot be read.
+     */
+    std::optional<std::string> read_file(const std::filesystem::path& path);
+
+    /**
+     * @brief Expands files and directories into a sorted list of source files. Directories are walked recursively.
+     * @param paths The files and directories given on the command line.
+     * @param extension Only files with this extension are picked up from directories. Explicit files are always kept.
+     * @return std::vector<std::filesystem::path> The source files.
+     * @throws std::runtime_error if a path does not exist.
+     */
+    std::vector<std::filesystem::path> collect_sources(std::span<const std::string> paths, std::string_view extension);
+
+    /**
+     * @brief Gets the peak resident set size of the process.
+     * @return uint64_t The peak RSS in bytes.
+     */
+    uint64_t peak_rss_bytes();
+
+    /**
+     * @brief Gets the default daemon socket path: $XDG_RUNTIME_DIR/nightglow.sock, or /tmp/nightglow-<uid>.sock.
+     */
+    std::string default_socket_path();
+
+    /**
+     * @brief Parses a whole command line argument as an unsigned number.
+     * @param text The argument.
+     * @return std::optional<uint32_t> The number, or std::nullopt if the argument is not a number or is out of range.
+     */
+    std::optional<uint32_t> parse_number(std::string_view text);
+
+    /**
+     * @brief Formats a byte count with a binary unit, e.g. "12.3 MiB".
+     */
+    std::string format_bytes(uint64_t bytes);
+}
+
+#endif
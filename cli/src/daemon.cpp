@@ -0,0 +1,360 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "commands.h"
+#include "common.h"
+#include "lexer.h"
+#include "parser.h"
+#include "token_cache.h"
+#include "token_packed.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    using namespace nightglow;
+
+    /**
+     * @brief A file whose token stream is kept resident, compressed, between requests.
+     */
+    struct resident_file
+    {
+        uint64_t hash{};
+        uint32_t size{};
+        lang::packed::PackedTokenList tokens;
+        lang::memory::vector<uint32_t> line_starts;
+    };
+
+    struct server_state
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const resident_file>> files;
+        std::atomic<uint64_t> requests{};
+        std::atomic<uint64_t> hits{};
+        std::atomic<uint64_t> misses{};
+        std::atomic<uint32_t> active{};
+        std::atomic<bool> stopping{};
+        int listen_fd = -1;
+    };
+
+    sockaddr_un make_address(const std::string& path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+
+    bool write_all(const int fd, const std::string_view data)
+    {
+        size_t written = 0;
+        while (written < data.size())
+        {
+            const ssize_t n = write(fd, data.data() + written, data.size() - written);
+            if (n <= 0)
+                return false;
+            written += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::vector<std::string> read_request(const int fd)
+    {
+        constexpr size_t max_request = 64 * 1024;
+        std::string line;
+        char buffer[4096];
+        while (line.size() < max_request && line.find('\n') == std::string::npos)
+        {
+            const ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0)
+                break;
+            line.append(buffer, static_cast<size_t>(n));
+        }
+        line = line.substr(0, line.find('\n'));
+
+        std::vector<std::string> fields;
+        std::istringstream in(line);
+        for (std::string field; std::getline(in, field, '\t');)
+        {
+            fields.push_back(field);
+        }
+        return fields;
+    }
+
+    /**
+     * @brief Returns the resident tokens for a file, re-lexing only if its contents changed since the last request.
+     */
+    std::shared_ptr<const resident_file> resolve(server_state& state, const std::string& path, const std::string& src, bool& hit)
+    {
+        const uint64_t hash = lang::cache::hash_source(src);
+        {
+            std::lock_guard lock(state.mutex);
+            if (const auto it = state.files.find(path); it != state.files.end() && it->second->hash == hash && it->second->size == src.size())
+            {
+                hit = true;
+                return it->second;
+            }
+        }
+
+        hit = false;
+        auto lexer = lang::lexer::create_lexer(src, src.size());
+        const lang::TokenList* tokens = lang::lexer::tokenize(lexer);
+
+        auto entry = std::make_shared<resident_file>();
+        entry->hash = hash;
+        entry->size = static_cast<uint32_t>(src.size());
+        entry->tokens = lang::packed::compress(*tokens);
+        entry->line_starts = std::move(lexer.line_starts);
+
+        std::lock_guard lock(state.mutex);
+        state.files[path] = entry;
+        return entry;
+    }
+
+    std::string handle(server_state& state, const std::vector<std::string>& request)
+    {
+        ++state.requests;
+        if (request.empty())
+            return "error empty request\n";
+
+        const std::string& command = request[0];
+        if (command == "stats")
+        {
+            std::lock_guard lock(state.mutex);
+            size_t resident = 0;
+            for (const auto& [path, file] : state.files)
+            {
+                resident += file->tokens.memory_usage() + file->line_starts.capacity() * sizeof(uint32_t);
+            }
+            std::ostringstream out;
+            out << "ok\nfiles " << state.files.size() << "\nresident " << cli::format_bytes(resident)
+                << "\nrequests " << state.requests << "\nhits " << state.hits << "\nmisses " << state.misses
+                << "\npeak_rss " << cli::format_bytes(cli::peak_rss_bytes()) << "\n";
+            return out.str();
+        }
+        if (command == "shutdown")
+        {
+            state.stopping = true;
+            ::shutdown(state.listen_fd, SHUT_RDWR);
+            return "ok\n";
+        }
+        if (command != "lex" && command != "tokens" && command != "parse" && command != "check")
+            return "error unknown command '" + command + "'\n";
+        if (request.size() != 2)
+            return "error usage: " + command + " <path>\n";
+
+        std::error_code ec;
+        const std::string path = std::filesystem::weakly_canonical(request[1], ec).string();
+        const std::optional<std::string> src = cli::read_file(path);
+        if (!src)
+            return "error cannot read " + request[1] + "\n";
+
+        try
+        {
+            bool hit = false;
+            const auto begin = std::chrono::steady_clock::now();
+            const auto file = resolve(state, path, *src, hit);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+            ++(hit ? state.hits : state.misses);
+
+            std::ostringstream out;
+            out << "ok\n";
+            if (command == "lex")
+            {
+                out << "tokens " << file->tokens.size() << "\nbytes " << file->size << "\ncache " << (hit ? "hit" : "miss")
+                    << "\ntime_us " << elapsed.count() << "\n";
+                return out.str();
+            }
+            if (command == "parse" || command == "check")
+            {
+                // the parser reads a lexer, so the resident stream is unpacked into one over the same source
+                auto lexer = lang::lexer::create_lexer(*src, src->size());
+                lexer.tokens = lang::packed::decompress(file->tokens);
+                lexer.line_starts = file->line_starts;
+                const lang::ast::Ast tree = lang::parser::parse(lexer);
+                if (command == "parse")
+                {
+                    out << "nodes " << tree.kinds.size() << "\nerrors " << tree.errors.size() << "\ncache " << (hit ? "hit" : "miss")
+                        << "\ntime_us " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() << "\n";
+                    return out.str();
+                }
+                for (size_t i = 0; i < tree.errors.size(); ++i)
+                {
+                    out << lang::parser::format_error(lexer, tree.errors[i]) << '\n';
+                }
+                return out.str();
+            }
+
+            lang::packed::for_each_block(file->tokens, [&](const lang::packed::token_block& block)
+            {
+                for (uint32_t i = 0; i < block.size; ++i)
+                {
+                    const auto line = std::ranges::upper_bound(file->line_starts, block.starts[i]) - 1;
+                    out << std::distance(file->line_starts.begin(), line) + 1 << ':' << block.starts[i] - *line + 1 << '\t'
+                        << lang::token_name(block.types[i]) << '\t' << std::string_view(src->data() + block.starts[i], block.lengths[i]) << '\n';
+                }
+            });
+            return out.str();
+        }
+        catch (const std::exception& e)
+        {
+            return std::string("error ") + e.what() + "\n";
+        }
+    }
+
+    void serve(server_state& state, const int fd)
+    {
+        write_all(fd, handle(state, read_request(fd)));
+        close(fd);
+        if (state.active.fetch_sub(1) == 1)
+            state.active.notify_all();
+    }
+
+    std::string socket_option(const std::span<const std::string> args, std::vector<std::string>& rest)
+    {
+        std::string socket = cli::default_socket_path();
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            if (args[i] == "--socket" && i + 1 < args.size())
+                socket = args[++i];
+            else
+                rest.push_back(args[i]);
+        }
+        return socket;
+    }
+}
+
+int nightglow::cli::daemon_command(const std::span<const std::string> args)
+{
+    std::vector<std::string> rest;
+    const std::string socket_path = socket_option(args, rest);
+    if (!rest.empty())
+    {
+        std::cerr << "usage: Nightglow daemon [--socket <path>]\n";
+        return 2;
+    }
+
+    const sockaddr_un address = make_address(socket_path);
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Nightglow daemon: socket path too long: " << socket_path << "\n";
+        return 1;
+    }
+
+    // a stale socket file is removed, a live daemon is left alone
+    if (const int probe = socket(AF_UNIX, SOCK_STREAM, 0); probe >= 0)
+    {
+        const bool live = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        if (live)
+        {
+            std::cerr << "Nightglow daemon: already running on " << socket_path << "\n";
+            return 1;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    server_state state;
+    state.listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (state.listen_fd < 0
+        || bind(state.listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || listen(state.listen_fd, 64) != 0)
+    {
+        std::cerr << "Nightglow daemon: cannot listen on " << socket_path << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    std::cerr << "Nightglow daemon: listening on " << socket_path << "\n";
+
+    while (!state.stopping)
+    {
+        const int fd = accept(state.listen_fd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        ++state.active;
+        std::thread(serve, std::ref(state), fd).detach();
+    }
+
+    // let in-flight requests finish before the state they reference goes away
+    for (uint32_t active = state.active; active != 0; active = state.active)
+    {
+        state.active.wait(active);
+    }
+    close(state.listen_fd);
+    unlink(socket_path.c_str());
+    return 0;
+}
+
+int nightglow::cli::request_command(const std::span<const std::string> args)
+{
+    std::vector<std::string> request;
+    const std::string socket_path = socket_option(args, request);
+    if (request.empty())
+    {
+        std::cerr << "usage: Nightglow request [--socket <path>] <lex|tokens|parse|check|stats|shutdown> [path]\n";
+        return 2;
+    }
+
+    // paths are resolved by the client so the daemon's working directory does not matter
+    if (request.size() > 1)
+    {
+        std::error_code ec;
+        request[1] = std::filesystem::absolute(request[1], ec).string();
+    }
+
+    const sockaddr_un address = make_address(socket_path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        std::cerr << "Nightglow request: no daemon on " << socket_path << "\n";
+        if (fd >= 0)
+            close(fd);
+        return 1;
+    }
+
+    std::string line;
+    for (size_t j = 0; j < request.size(); ++j)
+    {
+        line += (j ? "\t" : "") + request[j];
+    }
+    line += '\n';
+    write_all(fd, line);
+    ::shutdown(fd, SHUT_WR);
+
+    std::string response;
+    char buffer[64 * 1024];
+    for (ssize_t n; (n = read(fd, buffer, sizeof(buffer))) > 0;)
+    {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+
+    const size_t newline = response.find('\n');
+    const std::string status = response.substr(0, newline);
+    if (status != "ok")
+    {
+        std::cerr << "Nightglow request: " << (status.starts_with("error ") ? status.substr(6) : "malformed response") << "\n";
+        return 1;
+    }
+    std::cout << response.substr(newline + 1);
+    return 0;
+}
@@ -0,0 +1,291 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "commands.h"
+#include "common.h"
+#include "allocator.h"
+#include "lexer.h"
+#include "perf.h"
+#include "token_cache.h"
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+
+namespace
+{
+    enum class dump_format : uint8_t
+    {
+        NONE,
+        TEXT,
+        BINARY
+    };
+
+    void print_usage()
+    {
+        std::cerr <<
+            "usage: Nightglow lex [options] <file|dir>...\n"
+            "\n"
+            "  --dump=text      write each token stream as 'line:col TYPE value' lines\n"
+            "  --dump=binary    write each token stream in the mmap-able token cache format\n"
+            "  -o <dir>         directory for dumps, mirrored below each input's name (text dumps go to stdout without it)\n"
+            "  --ext <ext>      extension picked up when walking directories (default .ng)\n"
+            "  --perf           count cycles, instructions, branch and cache misses per phase (Linux perf_event)\n"
+            "  --brackets       match (), {} and [] while lexing and report the ones without a partner\n";
+    }
+
+    void dump_text(std::ostream& out, const nightglow::lang::lexer::Lexer& lexer)
+    {
+        using namespace nightglow::lang;
+        for (size_t i = 0; i < lexer.tokens.size(); ++i)
+        {
+            const token_t token = lexer.tokens[i];
+            const auto [line, col] = lexer::get_line_col(lexer, token);
+            out << line << ':' << col << '\t' << token_name(token.type) << '\t' << lexer::get_token_value(lexer, token) << '\n';
+        }
+    }
+
+    /**
+     * @brief Re-runs skip_whitespace_comment over every gap between the tokens of a lexed file, under the counters.
+     * Counting each call inside tokenize would cost a syscall per token, so the phase is replayed in isolation.
+     */
+    nightglow::lang::perf::counts replay_skips(const nightglow::lang::lexer::Lexer& lexer, nightglow::lang::perf::Counters& counters)
+    {
+        using namespace nightglow::lang;
+        lexer::LexerState state{ lexer.src, 0, lexer.src_length, {} };
+        state.line_starts.reserve(lexer.line_starts.size());
+
+        counters.start();
+        uint32_t end = 0;
+        for (size_t i = 0; i < lexer.tokens.size(); ++i)
+        {
+            state.current_pos = end;
+            lexer::skip_whitespace_comment(state, state.src, state.current_pos, state.src_length);
+            end = lexer.tokens.starts[i] + lexer.tokens.lengths[i];
+        }
+        return counters.stop();
+    }
+}
+
+int nightglow::cli::lex_command(const std::span<const std::string> args)
+{
+    auto format = dump_format::NONE;
+    std::filesystem::path out_dir;
+    std::string extension(source_extension);
+    std::vector<std::string> inputs;
+    auto count_events = false;
+    auto match_brackets = false;
+
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const std::string& arg = args[i];
+        if (arg == "--dump=text")
+            format = dump_format::TEXT;
+        else if (arg == "--dump=binary")
+            format = dump_format::BINARY;
+        else if (arg == "--perf")
+            count_events = true;
+        else if (arg == "--brackets")
+            match_brackets = true;
+        else if (arg == "-o" && i + 1 < args.size())
+            out_dir = args[++i];
+        else if (arg == "--ext" && i + 1 < args.size())
+            extension = args[++i];
+        else if (arg == "-h" || arg == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else if (arg.starts_with("-"))
+        {
+            std::cerr << "Nightglow lex: unknown option '" << arg << "'\n";
+            print_usage();
+            return 2;
+        }
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty())
+    {
+        print_usage();
+        return 2;
+    }
+    if (format == dump_format::BINARY && out_dir.empty())
+    {
+        std::cerr << "Nightglow lex: --dump=binary requires -o <dir>\n";
+        return 2;
+    }
+    if (!out_dir.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(out_dir, ec);
+        if (ec)
+        {
+            std::cerr << "Nightglow lex: cannot create " << out_dir.string() << ": " << ec.message() << "\n";
+            return 1;
+        }
+    }
+
+    // dumps mirror each source's path below a directory named after the input it was found in (a file input is
+    // dumped under its own name), so equal file names in different inputs do not overwrite each other; inputs
+    // with equal names get a numbered one
+    std::vector<std::filesystem::path> sources;
+    std::map<std::filesystem::path, std::filesystem::path> dump_of;
+    try
+    {
+        std::map<std::filesystem::path, std::filesystem::path> root_of;
+        for (const std::string& input : inputs)
+        {
+            const std::filesystem::path root(input);
+            const std::filesystem::path full = std::filesystem::absolute(root).lexically_normal();
+            const std::filesystem::path base = full.has_filename() ? full.filename() : full.parent_path().filename();
+            std::filesystem::path name = base;
+            for (uint32_t n = 2; !root_of.emplace(name, full).second && root_of.at(name) != full; ++n)
+            {
+                name = base.stem().string() + "-" + std::to_string(n) + base.extension().string();
+            }
+
+            for (const std::filesystem::path& file : collect_sources(std::span(&input, 1), extension))
+            {
+                sources.push_back(file);
+                dump_of.emplace(file, out_dir / (std::filesystem::is_directory(root) ? name / file.lexically_relative(root) : name));
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Nightglow lex: " << e.what() << "\n";
+        return 1;
+    }
+    std::ranges::sort(sources);
+    sources.erase(std::ranges::unique(sources).begin(), sources.end());
+
+    std::optional<lang::perf::Counters> counters;
+    lang::perf::counts tokenize_counts;
+    lang::perf::counts skip_counts;
+    if (count_events)
+    {
+        counters.emplace();
+        if (!counters->available())
+        {
+            std::cerr << "Nightglow lex: --perf: no hardware counters available (" << counters->error << ")\n";
+            counters.reset();
+        }
+    }
+
+    lang::memory::reset();
+    uint64_t total_bytes = 0;
+    uint64_t total_tokens = 0;
+    std::chrono::nanoseconds lex_time{};
+    auto status = 0;
+
+    for (const std::filesystem::path& path : sources)
+    {
+        const std::string name = path.string();
+        NIGHTGLOW_TRACE_SCOPE("file", name);
+
+        std::optional<std::string> src;
+        {
+            NIGHTGLOW_TRACE_SCOPE("read_file", name);
+            src = read_file(path);
+        }
+        if (!src)
+        {
+            std::cerr << "Nightglow lex: cannot read " << path.string() << "\n";
+            status = 1;
+            continue;
+        }
+
+        try
+        {
+            if (counters)
+                counters->start();
+            const auto begin = std::chrono::steady_clock::now();
+            auto lexer = lang::lexer::create_lexer(*src, src->size());
+            lexer.match_brackets = match_brackets;
+            const lang::TokenList* tokens = lang::lexer::tokenize(lexer);
+            lex_time += std::chrono::steady_clock::now() - begin;
+            if (counters)
+            {
+                tokenize_counts += counters->stop();
+                skip_counts += replay_skips(lexer, *counters);
+            }
+
+            total_bytes += src->size();
+            total_tokens += tokens->size();
+            for (const uint32_t i : tokens->unmatched)
+            {
+                const lang::token_t token = (*tokens)[i];
+                const auto [line, col] = lang::lexer::get_line_col(lexer, token);
+                std::cerr << path.string() << ':' << line << ':' << col << ": unmatched '" << lang::lexer::get_token_value(lexer, token) << "'\n";
+                status = 1;
+            }
+
+            NIGHTGLOW_TRACE_SCOPE("dump", name);
+            if (format == dump_format::TEXT && out_dir.empty())
+            {
+                std::cout << "== " << path.string() << "\n";
+                dump_text(std::cout, lexer);
+            }
+            else if (format != dump_format::NONE)
+            {
+                std::filesystem::path dump = dump_of.at(path);
+                std::error_code ec;
+                std::filesystem::create_directories(dump.parent_path(), ec);
+                dump += format == dump_format::TEXT ? ".tokens" : ".ngtok";
+                auto written = !ec;
+                if (written && format == dump_format::TEXT)
+                {
+                    std::ofstream out(dump);
+                    if (out)
+                        dump_text(out, lexer);
+                    out.close();
+                    written = !out.fail();
+                }
+                else if (written)
+                    written = lang::cache::write(dump, lexer);
+                if (!written)
+                {
+                    std::cerr << "Nightglow lex: cannot write dump for " << path.string() << " to " << dump.string() << "\n";
+                    status = 1;
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Nightglow lex: " << path.string() << ": " << e.what() << "\n";
+            status = 1;
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(lex_time).count();
+    const double mb_per_s = seconds > 0 ? static_cast<double>(total_bytes) / 1e6 / seconds : 0.0;
+    const double tokens_per_s = seconds > 0 ? static_cast<double>(total_tokens) / seconds : 0.0;
+    const double bytes_per_token = total_tokens > 0 ? static_cast<double>(total_bytes) / static_cast<double>(total_tokens) : 0.0;
+
+    std::fprintf(stderr, "files        %zu\n", sources.size());
+    std::fprintf(stderr, "bytes        %s\n", format_bytes(total_bytes).c_str());
+    std::fprintf(stderr, "tokens       %llu\n", static_cast<unsigned long long>(total_tokens));
+    std::fprintf(stderr, "lex time     %.3f ms\n", seconds * 1e3);
+    std::fprintf(stderr, "throughput   %.1f MB/s, %.2f Mtokens/s\n", mb_per_s, tokens_per_s / 1e6);
+    std::fprintf(stderr, "bytes/token  %.2f\n", bytes_per_token);
+    const lang::memory::stats heap = lang::memory::snapshot();
+    const double source_bytes = total_bytes > 0 ? static_cast<double>(total_bytes) : 1.0;
+    std::fprintf(stderr, "heap         %s in %llu allocations, %s peak\n", format_bytes(heap.allocated_bytes).c_str(),
+                 static_cast<unsigned long long>(heap.allocations), format_bytes(heap.peak_bytes).c_str());
+    std::fprintf(stderr, "heap/byte    %.2f allocated, %.2f peak\n", static_cast<double>(heap.allocated_bytes) / source_bytes,
+                 static_cast<double>(heap.peak_bytes) / source_bytes);
+    std::fprintf(stderr, "peak RSS     %s\n", format_bytes(peak_rss_bytes()).c_str());
+    if (counters)
+    {
+        lang::perf::print_report(std::cerr, "tokenize", tokenize_counts, total_bytes, total_tokens);
+        lang::perf::print_report(std::cerr, "skip_whitespace_comment", skip_counts, total_bytes, total_tokens);
+    }
+    return status;
+}
@@ -0,0 +1,350 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifdef __linux__
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "commands.h"
+#include "common.h"
+#include "incremental.h"
+#include "token_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <ranges>
+#include <set>
+#include <unordered_map>
+
+#ifdef __linux__
+namespace
+{
+    using namespace nightglow;
+
+    /**
+     * @brief State retained per file between edits. A save is applied to the document as an edit, so only the
+     * tokens and statements it touches are lexed and parsed again.
+     */
+    struct watched_file
+    {
+        uint64_t hash{};
+        size_t size{};
+        lang::incremental::Document document;
+    };
+
+    volatile std::sig_atomic_t interrupted = 0;
+
+    void on_interrupt(int)
+    {
+        interrupted = 1;
+    }
+
+    struct watcher
+    {
+        int inotify_fd = -1;
+        int listen_fd = -1;
+        std::string extension;
+        std::unordered_map<int, std::filesystem::path> directories;
+        std::unordered_map<std::string, std::unique_ptr<watched_file>> files;
+        std::vector<int> subscribers;
+
+        void emit(const std::string& line)
+        {
+            if (listen_fd < 0)
+            {
+                std::cout << line << '\n' << std::flush;
+                return;
+            }
+
+            const std::string message = line + '\n';
+            std::erase_if(subscribers, [&message](const int fd)
+            {
+                if (write(fd, message.data(), message.size()) == static_cast<ssize_t>(message.size()))
+                    return false;
+                close(fd);
+                return true;
+            });
+        }
+
+        void watch_directory(const std::filesystem::path& dir)
+        {
+            constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_ONLYDIR;
+            if (const int wd = inotify_add_watch(inotify_fd, dir.c_str(), mask); wd >= 0)
+            {
+                directories[wd] = dir;
+            }
+        }
+
+        void add_tree(const std::filesystem::path& root, std::set<std::string>& changed)
+        {
+            watch_directory(root);
+            std::error_code ec;
+            for (auto it = std::filesystem::recursive_directory_iterator(root, ec); !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+            {
+                if (it->is_directory())
+                    watch_directory(it->path());
+                else if (it->is_regular_file() && it->path().extension() == extension)
+                    changed.insert(it->path().string());
+            }
+        }
+
+        void process(const std::string& path)
+        {
+            const std::optional<std::string> contents = cli::read_file(path);
+            if (!contents)
+            {
+                if (files.erase(path))
+                    emit("removed " + path);
+                return;
+            }
+
+            auto& file = files[path];
+            const uint64_t hash = lang::cache::hash_source(*contents);
+            if (file && file->hash == hash && file->size == contents->size())
+                return;
+
+            try
+            {
+                const auto begin = std::chrono::steady_clock::now();
+                lang::incremental::edit_stats stats{ 0, 0, 0, true };
+                if (!file)
+                {
+                    file = std::make_unique<watched_file>();
+                    file->document = lang::incremental::open_document(*contents);
+                }
+                else
+                {
+                    // editors rewrite the whole file on save, so the edit spans from the first to the last byte that differ
+                    lang::incremental::Document& document = file->document;
+                    lang::incremental::settle(document);
+                    const std::string_view before = document.text;
+                    const std::string_view after = *contents;
+                    const size_t prefix = std::ranges::mismatch(before, after).in1 - before.begin();
+                    const size_t suffix = std::ranges::mismatch(before.substr(prefix) | std::views::reverse,
+                                                                after.substr(prefix) | std::views::reverse).in1 - before.rbegin();
+                    stats = lang::incremental::apply_edit(document, { static_cast<uint32_t>(prefix), static_cast<uint32_t>(before.size() - prefix - suffix),
+                                                                      after.substr(prefix, after.size() - prefix - suffix) });
+                }
+                file->hash = hash;
+                file->size = contents->size();
+                lang::incremental::Document& document = file->document;
+                const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+
+                emit("parsed " + path + " tokens=" + std::to_string(document.lexer.tokens.size() - document.token_gap.size)
+                     + " bytes=" + std::to_string(contents->size()) + " relexed=" + std::to_string(stats.relexed_tokens)
+                     + " reparsed=" + std::to_string(stats.reparsed_tokens) + " full=" + (stats.full ? "1" : "0")
+                     + " errors=" + std::to_string(document.ast.errors.size()) + " us=" + std::to_string(elapsed.count()));
+                if (document.ast.errors.size() != 0)
+                {
+                    lang::incremental::settle(document);
+                    for (size_t i = 0; i < document.ast.errors.size(); ++i)
+                    {
+                        emit("syntax " + path + ":" + lang::parser::format_error(document.lexer, document.ast.errors[i]));
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                files.erase(path);
+                emit("error " + path + " " + e.what());
+            }
+        }
+
+        /**
+         * @brief Drains pending inotify events into the set of changed paths.
+         */
+        void collect(std::set<std::string>& changed)
+        {
+            alignas(inotify_event) char buffer[64 * 1024];
+            for (ssize_t n; (n = read(inotify_fd, buffer, sizeof(buffer))) > 0;)
+            {
+                for (ssize_t offset = 0; offset < n;)
+                {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                    const auto dir = directories.find(event->wd);
+                    if (dir == directories.end())
+                        continue;
+                    if (event->mask & (IN_DELETE_SELF | IN_IGNORED))
+                    {
+                        directories.erase(dir);
+                        continue;
+                    }
+                    if (event->len == 0)
+                        continue;
+
+                    const std::filesystem::path path = dir->second / event->name;
+                    if (event->mask & IN_ISDIR)
+                    {
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                            add_tree(path, changed);
+                    }
+                    else if (path.extension() == extension)
+                    {
+                        changed.insert(path.string());
+                    }
+                }
+            }
+        }
+    };
+
+    int open_output(const std::string& socket_path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (socket_path.size() >= sizeof(address.sun_path))
+            return -1;
+        std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        unlink(socket_path.c_str());
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0)
+        {
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+        return fd;
+    }
+}
+#endif
+
+int nightglow::cli::watch_command(const std::span<const std::string> args)
+{
+    #ifdef __linux__
+    std::vector<std::string> roots;
+    std::string socket_path;
+    std::string extension(source_extension);
+    auto debounce_ms = 2;
+
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == "--socket" && i + 1 < args.size())
+            socket_path = args[++i];
+        else if (args[i] == "--ext" && i + 1 < args.size())
+            extension = args[++i];
+        else if (args[i] == "--debounce" && i + 1 < args.size())
+        {
+            const std::optional<uint32_t> parsed = parse_number(args[++i]);
+            if (!parsed)
+            {
+                std::cerr << "Nightglow watch: --debounce expects a number of milliseconds, got '" << args[i] << "'\n";
+                return 2;
+            }
+            debounce_ms = static_cast<int>(std::min<uint32_t>(*parsed, INT32_MAX));
+        }
+        else if (args[i].starts_with("-"))
+        {
+            std::cerr << "Nightglow watch: unknown option '" << args[i] << "'\n";
+            return 2;
+        }
+        else
+            roots.push_back(args[i]);
+    }
+
+    if (roots.empty())
+    {
+        std::cerr << "usage: Nightglow watch [--socket <path>] [--ext <ext>] [--debounce <ms>] <dir>...\n";
+        return 2;
+    }
+
+    watcher w;
+    w.extension = extension;
+    w.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (w.inotify_fd < 0)
+    {
+        std::cerr << "Nightglow watch: inotify_init1 failed: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    if (!socket_path.empty() && (w.listen_fd = open_output(socket_path)) < 0)
+    {
+        std::cerr << "Nightglow watch: cannot listen on " << socket_path << "\n";
+        return 1;
+    }
+
+    struct sigaction action{};
+    action.sa_handler = on_interrupt;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::set<std::string> changed;
+    for (const std::string& root : roots)
+    {
+        if (!std::filesystem::is_directory(root))
+        {
+            std::cerr << "Nightglow watch: not a directory: " << root << "\n";
+            return 1;
+        }
+        w.add_tree(std::filesystem::absolute(root), changed);
+    }
+    for (const std::string& path : changed)
+    {
+        w.process(path);
+    }
+    changed.clear();
+    std::cerr << "Nightglow watch: watching " << w.directories.size() << " directories, " << w.files.size() << " files\n";
+
+    while (!interrupted)
+    {
+        pollfd fds[2] = { { w.inotify_fd, POLLIN, 0 }, { w.listen_fd, POLLIN, 0 } };
+        if (poll(fds, w.listen_fd >= 0 ? 2 : 1, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (w.listen_fd >= 0 && (fds[1].revents & POLLIN))
+        {
+            for (int fd; (fd = accept4(w.listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;)
+            {
+                w.subscribers.push_back(fd);
+            }
+        }
+        if (!(fds[0].revents & POLLIN))
+            continue;
+
+        // editors save in bursts (truncate, write, rename); wait for a short quiet period before applying the edits
+        w.collect(changed);
+        pollfd quiet = { w.inotify_fd, POLLIN, 0 };
+        while (!interrupted && poll(&quiet, 1, debounce_ms) > 0)
+        {
+            w.collect(changed);
+        }
+
+        for (const std::string& path : changed)
+        {
+            w.process(path);
+        }
+        changed.clear();
+    }
+
+    for (const int fd : w.subscribers)
+    {
+        close(fd);
+    }
+    if (w.listen_fd >= 0)
+    {
+        close(w.listen_fd);
+        unlink(socket_path.c_str());
+    }
+    close(w.inotify_fd);
+    return 0;
+    #else
+    static_cast<void>(args);
+    std::cerr << "Nightglow watch: requires inotify, which is only available on Linux\n";
+    return 1;
+    #endif
+}
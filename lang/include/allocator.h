@@ -0,0 +1,178 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace nightglow::lang::memory
+{
+    /**
+     * @brief The allocation functions behind every frontend container. The defaults forward to the global
+     * aligned operator new and delete.
+     */
+    struct allocator_hooks
+    {
+        void* (*allocate)(size_t bytes, size_t alignment, void* context);
+        void (*deallocate)(void* p, size_t bytes, size_t alignment, void* context);
+        void* context;
+    };
+
+    /**
+     * @brief Heap usage of the frontend containers since the last reset().
+     */
+    struct stats
+    {
+        uint64_t allocated_bytes;
+        uint64_t live_bytes;
+        uint64_t peak_bytes;
+        uint64_t allocations;
+        uint64_t deallocations;
+    };
+
+    /**
+     * @brief Replaces the allocation functions. Must be called before any frontend container allocates,
+     * or the new hooks must be able to free what the old ones allocated. Not thread-safe.
+     * @param hooks The new hooks.
+     */
+    void set_hooks(const allocator_hooks& hooks);
+
+    /**
+     * @brief Gets the hooks that were installed at startup.
+     */
+    const allocator_hooks& default_hooks();
+
+    /**
+     * @brief Reads the counters. Cheap enough to call around every phase.
+     */
+    stats snapshot();
+
+    /**
+     * @brief Zeroes the counters and restarts the peak from the bytes currently live.
+     */
+    void reset();
+
+    /**
+     * @brief Allocates through the installed hooks and counts the allocation.
+     * @throws std::bad_alloc if the hook returns null.
+     */
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * @brief Frees through the installed hooks and counts the deallocation.
+     */
+    void deallocate(void* p, size_t bytes, size_t alignment);
+
+    /**
+     * @brief A standard allocator that routes through the hooks, so container memory shows up in the counters.
+     */
+    template<typename T>
+    struct Allocator
+    {
+        using value_type = T;
+
+        Allocator() = default;
+
+        template<typename U>
+        Allocator(const Allocator<U>&) noexcept
+        {
+        }
+
+        [[nodiscard]] T* allocate(const size_t n)
+        {
+            return static_cast<T*>(memory::allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, const size_t n) noexcept
+        {
+            memory::deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        template<typename U>
+        bool operator==(const Allocator<U>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    /**
+     * @brief The vector used by every frontend container.
+     */
+    template<typename T>
+    using vector = std::vector<T, Allocator<T>>;
+
+    /**
+     * @brief A bump allocator. Memory is taken from the hooks in chunks and only handed back all at once,
+     * so freeing everything costs one call per chunk regardless of how many objects were allocated.
+     */
+    struct Arena
+    {
+        struct chunk
+        {
+            chunk* next;
+            size_t size;
+        };
+
+        /**
+         * @brief Size of the first chunk. Later chunks double, up to max_chunk_size.
+         */
+        static constexpr size_t min_chunk_size = 64 * 1024;
+        static constexpr size_t max_chunk_size = 16 * 1024 * 1024;
+
+        chunk* head{};
+        char* cursor{};
+        char* limit{};
+        size_t used{};
+
+        Arena() = default;
+        Arena(Arena&& other) noexcept;
+        Arena& operator=(Arena&& other) noexcept;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+        ~Arena();
+
+        /**
+         * @brief Allocates uninitialized memory that lives until reset() or release().
+         * @throws std::bad_alloc if the hooks fail.
+         */
+        void* allocate(size_t bytes, size_t alignment);
+
+        template<typename T>
+        T* allocate_array(const size_t n)
+        {
+            return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * @brief Tries to grow the most recent allocation in place.
+         * @return bool True if p now has new_bytes bytes.
+         */
+        bool extend(const void* p, size_t old_bytes, size_t new_bytes);
+
+        /**
+         * @brief Forgets every allocation but keeps the most recent chunk for reuse.
+         */
+        void reset();
+
+        /**
+         * @brief Gives every chunk back to the hooks.
+         */
+        void release();
+
+        /**
+         * @brief Bytes handed out since the last reset().
+         */
+        [[nodiscard]] size_t bytes_used() const
+        {
+            return used;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,240 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef AST_H
+#define AST_H
+
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <type_traits>
+#include "lexer.h"
+
+namespace nightglow::lang::ast
+{
+    /**
+     * @brief A handle to a node. Handles are indices into the columns of an Ast and stay valid until it is cleared.
+     */
+    using node_id = uint32_t;
+
+    inline constexpr node_id no_node = 0xFFFFFFFF;
+
+    /**
+     * @brief What a node represents. Where a node has a name, an operator or a keyword, its token points at it.
+     */
+    enum class node_kind : uint8_t
+    {
+        MODULE,
+        IMPORT,
+        FUNCTION,
+        PARAMETER,
+        CLASS,
+        ENUM,
+        VARIABLE,
+        ANNOTATION,
+        TYPE,
+        BLOCK,
+        LAZY_BLOCK,
+        IF,
+        FOR,
+        WHILE,
+        RETURN,
+        BREAK,
+        CONTINUE,
+        EXPRESSION,
+        IDENTIFIER,
+        LITERAL,
+        UNARY,
+        BINARY,
+        ASSIGN,
+        CONDITIONAL,
+        CALL,
+        INDEX,
+        MEMBER,
+        ERROR
+    };
+
+    inline constexpr std::array<std::string_view, static_cast<size_t>(node_kind::ERROR) + 1> node_kind_names = {
+        "MODULE", "IMPORT", "FUNCTION", "PARAMETER", "CLASS", "ENUM", "VARIABLE", "ANNOTATION", "TYPE", "BLOCK",
+        "LAZY_BLOCK", "IF", "FOR", "WHILE", "RETURN", "BREAK", "CONTINUE", "EXPRESSION", "IDENTIFIER", "LITERAL", "UNARY",
+        "BINARY", "ASSIGN", "CONDITIONAL", "CALL", "INDEX", "MEMBER", "ERROR"
+    };
+
+    constexpr std::string_view node_kind_name(const node_kind kind)
+    {
+        return node_kind_names[static_cast<size_t>(kind)];
+    }
+
+    /**
+     * @brief A syntax error: the token where parsing stopped making sense and what was expected there.
+     */
+    struct syntax_error
+    {
+        uint32_t token;
+        std::string_view expected; // a token name or a static description, e.g. "expression"
+    };
+
+    /**
+     * @brief A growable array of trivially copyable values that lives in an arena. Growing copies into a
+     * new block unless the column is the newest allocation; the old block is reclaimed with the arena.
+     */
+    template<typename T>
+    struct Column
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        T* data{};
+        uint32_t count{};
+        uint32_t capacity{};
+
+        Column() = default;
+        Column(Column&& other) noexcept
+            : data(std::exchange(other.data, nullptr)), count(std::exchange(other.count, 0)), capacity(std::exchange(other.capacity, 0))
+        {
+        }
+        Column& operator=(Column&& other) noexcept
+        {
+            data = std::exchange(other.data, nullptr);
+            count = std::exchange(other.count, 0);
+            capacity = std::exchange(other.capacity, 0);
+            return *this;
+        }
+
+        void reserve(memory::Arena& arena, const uint32_t n)
+        {
+            if (n <= capacity)
+                return;
+            if (data != nullptr && arena.extend(data, capacity * sizeof(T), n * sizeof(T)))
+            {
+                capacity = n;
+                return;
+            }
+            T* fresh = arena.allocate_array<T>(n);
+            if (count > 0)
+                std::memcpy(fresh, data, count * sizeof(T));
+            data = fresh;
+            capacity = n;
+        }
+
+        void push_back(memory::Arena& arena, const T& value)
+        {
+            if (count == capacity)
+                reserve(arena, capacity < 16 ? 16 : capacity * 2);
+            data[count++] = value;
+        }
+
+        void append(memory::Arena& arena, const std::span<const T> values)
+        {
+            if (count + values.size() > capacity)
+                reserve(arena, std::max<uint32_t>(static_cast<uint32_t>(count + values.size()), capacity * 2));
+            if (!values.empty())
+                std::memcpy(data + count, values.data(), values.size() * sizeof(T));
+            count += static_cast<uint32_t>(values.size());
+        }
+
+        [[nodiscard]] uint32_t size() const
+        {
+            return count;
+        }
+
+        T& operator[](const size_t i)
+        {
+            return data[i];
+        }
+
+        const T& operator[](const size_t i) const
+        {
+            return data[i];
+        }
+    };
+
+    /**
+     * @brief A syntax tree stored as columns in a bump arena. Nodes refer to tokens of the TokenList they were
+     * parsed from by index and never copy source text. Children of a node are a contiguous range of edges;
+     * an optional child that is absent in a fixed layout (e.g. the parts of a for loop) is no_node.
+     * Syntax errors are kept beside the nodes; the tokens they skipped are covered by ERROR nodes.
+     */
+    struct Ast
+    {
+        memory::Arena arena;
+        Column<node_kind> kinds;
+        Column<uint32_t> tokens;
+        Column<uint32_t> begins;
+        Column<uint32_t> ends;
+        Column<uint32_t> child_begins;
+        Column<uint32_t> child_counts;
+        Column<node_id> edges;
+        Column<syntax_error> errors;
+        node_id root{ no_node };
+
+        Ast() = default;
+        Ast(Ast&&) noexcept = default;
+        Ast& operator=(Ast&&) noexcept = default;
+
+        /**
+         * @brief Reserves room for nodes and as many edges, so a parse of a known size never regrows.
+         * @param nodes The expected number of nodes.
+         */
+        void reserve(uint32_t nodes);
+
+        /**
+         * @brief Appends a node.
+         * @param kind The node kind.
+         * @param token The index of the node's main token: its name, operator or keyword.
+         * @param begin The index of the first token covered by the node.
+         * @param end One past the index of the last token covered by the node.
+         * @param children The node's children, in source order. Copied.
+         * @return node_id The handle of the new node.
+         */
+        node_id add(node_kind kind, uint32_t token, uint32_t begin, uint32_t end, std::span<const node_id> children = {});
+
+        /**
+         * @brief Copies every node and error of another tree to the end of this one, remapping its child handles.
+         * The root of the other tree is not linked anywhere; its handle is other.root plus the returned offset.
+         * @param other The tree to copy. Its token indices must refer to the same TokenList.
+         * @return node_id The offset added to the handles of the copied nodes.
+         */
+        node_id append(const Ast& other);
+
+        /**
+         * @brief Drops every node. Costs the same no matter how large the tree is; the arena keeps its last chunk.
+         */
+        void clear();
+
+        [[nodiscard]] uint32_t size() const
+        {
+            return kinds.size();
+        }
+
+        [[nodiscard]] node_kind kind(const node_id id) const { return kinds[id]; }
+        [[nodiscard]] uint32_t token(const node_id id) const { return tokens[id]; }
+        [[nodiscard]] uint32_t begin(const node_id id) const { return begins[id]; }
+        [[nodiscard]] uint32_t end(const node_id id) const { return ends[id]; }
+
+        [[nodiscard]] std::span<const node_id> children(const node_id id) const
+        {
+            return { edges.data + child_begins[id], child_counts[id] };
+        }
+
+        /**
+         * @brief Bytes held by the tree.
+         */
+        [[nodiscard]] size_t memory_usage() const
+        {
+            return arena.bytes_used();
+        }
+    };
+
+    /**
+     * @brief Prints a tree, one node per line, indented by depth.
+     * @param out The stream to print to.
+     * @param ast The tree.
+     * @param lexer The lexer the tree was parsed from, after tokenize() has been called.
+     * @param id The node to start from, the root by default.
+     */
+    void dump(std::ostream& out, const Ast& ast, const lexer::Lexer& lexer, node_id id = no_node);
+}
+
+#endif
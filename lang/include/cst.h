@@ -0,0 +1,66 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef CST_H
+#define CST_H
+
+#include <span>
+#include "ast.h"
+
+namespace nightglow::lang::cst
+{
+    /**
+     * @brief A lossless view of a tree, for formatters and refactoring tools: every node can be given back with
+     * the comments and whitespace around it. Needs a lexer that was tokenized with LexerState::keep_trivia; without
+     * trivia every node still has its text, but no leading or trailing trivia.
+     *
+     * The trivia before a token is split at its first line break: what comes before it trails the previous token,
+     * the rest leads this one. Trivia at the start of the file leads the first token, so every run belongs to
+     * exactly one token.
+     */
+    struct View
+    {
+        const lexer::Lexer& lexer;
+        const ast::Ast& ast;
+
+        /**
+         * @brief The trivia that leads a token: comments and blank lines above it, and indentation.
+         */
+        [[nodiscard]] std::span<const trivia_t> token_leading(uint32_t token) const;
+
+        /**
+         * @brief The trivia that trails a token on its line, e.g. a comment after a statement.
+         */
+        [[nodiscard]] std::span<const trivia_t> token_trailing(uint32_t token) const;
+
+        /**
+         * @brief The trivia that leads the first token of a node.
+         */
+        [[nodiscard]] std::span<const trivia_t> leading(ast::node_id id) const;
+
+        /**
+         * @brief The trivia that trails the last token of a node. Empty for nodes that cover no tokens.
+         */
+        [[nodiscard]] std::span<const trivia_t> trailing(ast::node_id id) const;
+
+        /**
+         * @brief The source of a node from its first to its last token, with the trivia in between.
+         */
+        [[nodiscard]] std::string_view text(ast::node_id id) const;
+
+        /**
+         * @brief The source of a node with its leading and trailing trivia. For a node that reaches the end of the
+         * file, this includes the trivia up to the end of the file.
+         */
+        [[nodiscard]] std::string_view full_text(ast::node_id id) const;
+
+        [[nodiscard]] std::string_view text(const trivia_t& trivia) const
+        {
+            return { lexer.src + trivia.start, trivia.length };
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,34 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef IMPORTS_H
+#define IMPORTS_H
+
+#include <string>
+#include <vector>
+#include "lexer.h"
+
+namespace nightglow::lang
+{
+    /**
+     * @brief An import declaration found at the top of a file.
+     */
+    struct import_decl
+    {
+        std::string module;
+        token_t token;
+    };
+
+    /**
+     * @brief Lexes only the leading `import a.b.c;` declarations of a source and stops at the first other token.
+     * Malformed imports end the scan.
+     * @param src The source code.
+     * @return memory::vector<import_decl> The imported module names in source order, dot separated.
+     * @throws std::runtime_error if the source file is too large (>4GiB) or a token is longer than 65535 bytes.
+     */
+    memory::vector<import_decl> scan_imports(std::string_view src);
+}
+
+#endif
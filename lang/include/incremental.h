@@ -0,0 +1,129 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <string>
+#include "parser.h"
+
+namespace nightglow::lang::incremental
+{
+    /**
+     * @brief A change to the text of a document: removed bytes starting at offset are replaced by inserted.
+     */
+    struct text_edit
+    {
+        uint32_t offset;
+        uint32_t removed;
+        std::string_view inserted;
+    };
+
+    /**
+     * @brief What an edit cost.
+     */
+    struct edit_stats
+    {
+        uint32_t relexed_tokens;   // tokens lexed again, in the new text
+        uint32_t reparsed_tokens;  // tokens covered by the statements parsed again
+        uint32_t replaced_nodes;   // nodes that were dropped from the tree
+        bool full;                 // the whole document was parsed again
+    };
+
+    /**
+     * @brief A run of unused slots in the middle of a column, left where the last edit was so that the next edits
+     * nearby only move what lies between them. Columns of byte offsets keep the entries past the gap as distances
+     * from the end of the text, which an edit in front of them does not change.
+     */
+    struct gap
+    {
+        uint32_t begin;
+        uint32_t size;
+    };
+
+    /**
+     * @brief An edit not yet applied to the tree: token indices at or past from, in nodes older than limit, are
+     * off by delta.
+     */
+    struct pending_shift
+    {
+        ast::node_id limit;
+        uint32_t from;
+        int64_t delta;
+    };
+
+    /**
+     * @brief A piece of the pending shifts added up: token indices from here up to the next piece are off by delta.
+     */
+    struct shift_piece
+    {
+        uint32_t from;
+        int64_t delta;
+    };
+
+    /**
+     * @brief A source file kept lexed and parsed across edits, for editors and watch mode.
+     *
+     * The tree is updated in place and only grows between compactions. An edit re-lexes from the token before it
+     * until the new tokens line up with the old ones again, and re-parses only the statements it touches in the
+     * innermost block or module that contains it. Every other node keeps its handle, and so do the errors. Nodes
+     * that were replaced stay in the arena until they outnumber the live ones, at which point the document is parsed
+     * from scratch and handles change.
+     *
+     * What an edit costs does not depend on the size of the file: the text, the token columns and the line starts
+     * keep a gap at the last edit, and the token indices of the nodes it moved are recorded as a pending shift
+     * instead of being rewritten. The shifts are applied to the tree once enough of them are pending that doing so
+     * costs no more per edit than looking through them. Call settle() before reading text, lexer or ast.
+     */
+    struct Document
+    {
+        std::string text;
+        lexer::Lexer lexer;
+        ast::Ast ast;
+        parser::parse_options options;
+        uint32_t garbage{};
+        gap text_gap{};
+        gap token_gap{};
+        gap line_gap{};
+        memory::vector<pending_shift> shifts;
+        memory::vector<shift_piece> composed;  // all the shifts at once, as the nodes older than the first one see them
+
+        Document() = default;
+        Document(Document&& other) noexcept;
+        Document& operator=(Document&& other) noexcept;
+    };
+
+    /**
+     * @brief Lexes and parses a source file.
+     * @param text The source code.
+     * @param options The parse options, used for every later parse of the document.
+     * @return Document The document.
+     * @throws std::runtime_error If the source is too large. Syntax errors are recorded in the tree.
+     */
+    Document open_document(std::string text, const parser::parse_options& options = {});
+
+    /**
+     * @brief Applies an edit to the text, then brings the tokens and the tree up to date.
+     * Falls back to parsing the whole document when the edit changes structure beyond the statements it touches,
+     * for example by unbalancing braces.
+     * @param document The document.
+     * @param edit The edit, in byte offsets of the current text.
+     * @return edit_stats What the update cost.
+     * @throws std::runtime_error If the edit is out of range, or if it leaves a token longer than 65535 bytes, after
+     * which the document cannot be used. Syntax errors are recorded in the tree, and errors of the statements that
+     * were parsed again are replaced by theirs.
+     */
+    edit_stats apply_edit(Document& document, const text_edit& edit);
+
+    /**
+     * @brief Closes the gaps and applies the pending shifts, so text, lexer and ast read as if the text had been
+     * lexed and parsed from scratch, except for node handles. Costs one pass over the file; the next edit reopens
+     * the gaps where it lands.
+     * @param document The document.
+     */
+    void settle(Document& document);
+}
+
+#endif
@@ -6,9 +6,11 @@
 #ifndef LANG_H
 #define LANG_H
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <vector>
-#include "../extern/robin_hood.h"
+#include <string_view>
+#include "allocator.h"
 
 namespace nightglow::lang
 {
@@ -127,9 +129,90 @@ namespace nightglow::lang
     };
 
     /**
-     * @brief A map to quickly lookup tokens.
+     * @brief Names of the token types, indexed by token_i.
      */
-    const robin_hood::unordered_flat_map<std::string_view, token_i> token_map = {
+    inline constexpr std::array<std::string_view, static_cast<size_t>(token_i::END_OF_FILE) + 1> token_names = {
+        "TRUE", "FALSE", "NIL", "IMPORT", "VAR", "CONST", "FUNCTION", "INLINE", "RETURN", "NEW", "ENUM",
+        "IF", "ELSE", "FOR", "WHILE", "BREAK", "CONTINUE", "SWITCH", "CASE", "DEFAULT", "CLASS", "EXTENDS",
+        "FINAL", "PUBLIC", "PRIVATE", "PROTECTED", "AWAIT", "ASYNC", "TRY", "CATCH", "U8", "I8", "U16",
+        "I16", "U32", "I32", "U64", "I64", "F32", "F64", "STRING", "BOOLEAN", "VOID", "AUTO", "UNIQUE",
+        "SHARED", "NULLABLE_U8", "NULLABLE_I8", "NULLABLE_U16", "NULLABLE_I16", "NULLABLE_U32",
+        "NULLABLE_I32", "NULLABLE_U64", "NULLABLE_I64", "NULLABLE_F32", "NULLABLE_F64", "NULLABLE_STRING",
+        "NULLABLE_BOOLEAN", "ARRAY_U8", "ARRAY_I8", "ARRAY_U16", "ARRAY_I16", "ARRAY_U32", "ARRAY_I32",
+        "ARRAY_U64", "ARRAY_I64", "ARRAY_F32", "ARRAY_F64", "ARRAY_STRING", "ARRAY_BOOLEAN",
+        "NULLABLE_ARRAY_U8", "NULLABLE_ARRAY_I8", "NULLABLE_ARRAY_U16", "NULLABLE_ARRAY_I16",
+        "NULLABLE_ARRAY_U32", "NULLABLE_ARRAY_I32", "NULLABLE_ARRAY_U64", "NULLABLE_ARRAY_I64",
+        "NULLABLE_ARRAY_F32", "NULLABLE_ARRAY_F64", "NULLABLE_ARRAY_STRING", "NULLABLE_ARRAY_BOOLEAN",
+        "PLUS", "MINUS", "STAR", "SLASH", "PERCENT", "EQUAL", "EQUAL_EQUAL", "BANG", "BANG_EQUAL", "LESS",
+        "LESS_EQUAL", "GREATER", "GREATER_EQUAL", "AND", "AND_AND", "OR", "OR_OR", "XOR", "TILDE",
+        "LEFT_SHIFT", "RIGHT_SHIFT", "PLUS_EQUAL", "MINUS_EQUAL", "STAR_EQUAL", "SLASH_EQUAL",
+        "PERCENT_EQUAL", "AND_EQUAL", "OR_EQUAL", "XOR_EQUAL", "LEFT_SHIFT_EQUAL", "RIGHT_SHIFT_EQUAL",
+        "ARROW", "DOT", "LEFT_PAREN", "RIGHT_PAREN", "LEFT_BRACE", "RIGHT_BRACE", "LEFT_BRACKET",
+        "RIGHT_BRACKET", "COMMA", "COLON", "SEMICOLON", "QUESTION", "ALIGN_ANNOT", "DEPRECATED_ANNOT",
+        "PACKED_ANNOT", "NO_DISCARD_ANNOT", "VOLATILE_ANNOT", "LAZY_ANNOT", "PURE_ANNOT", "TAIL_REC_ANNOT",
+        "IDENTIFIER", "NUM_LITERAL", "STR_LITERAL", "ANNOTATION", "UNKNOWN", "END_OF_FILE"
+    };
+
+    /**
+     * @brief Gets the name of a token type, e.g. "LEFT_PAREN".
+     * @param type The token type.
+     * @return std::string_view The name of the token type.
+     */
+    constexpr std::string_view token_name(const token_i type)
+    {
+        return token_names[static_cast<size_t>(type)];
+    }
+
+    /**
+     * @brief Whether a token type is a builtin type keyword, e.g. U8 or NULLABLE_ARRAY_BOOLEAN.
+     */
+    constexpr bool is_type_keyword(const token_i type)
+    {
+        return type >= token_i::U8 && type <= token_i::NULLABLE_ARRAY_BOOLEAN;
+    }
+
+    /**
+     * @brief Whether a token type is an annotation, builtin or not.
+     */
+    constexpr bool is_annotation(const token_i type)
+    {
+        return (type >= token_i::ALIGN_ANNOT && type <= token_i::TAIL_REC_ANNOT) || type == token_i::ANNOTATION;
+    }
+
+    /**
+     * @brief Whether a token type is a modifier that may precede a declaration keyword.
+     */
+    constexpr bool is_modifier(const token_i type)
+    {
+        return type == token_i::PUBLIC || type == token_i::PRIVATE || type == token_i::PROTECTED || type == token_i::FINAL
+            || type == token_i::INLINE || type == token_i::ASYNC;
+    }
+
+    /**
+     * @brief An entry of a constant token lookup table.
+     */
+    struct token_entry
+    {
+        std::string_view text;
+        token_i type;
+    };
+
+    /**
+     * @brief Sorts a token table by its text at compile time so it can be binary searched.
+     * @param table The unsorted table.
+     * @return std::array<token_entry, N> The sorted table.
+     */
+    template<size_t N>
+    consteval std::array<token_entry, N> sort_token_table(std::array<token_entry, N> table)
+    {
+        std::ranges::sort(table, {}, &token_entry::text);
+        return table;
+    }
+
+    /**
+     * @brief Keywords and built-in types, looked up after an identifier has been lexed.
+     */
+    inline constexpr auto keyword_table = sort_token_table(std::to_array<token_entry>({
         { "true", token_i::TRUE },
         { "false", token_i::FALSE },
         { "null", token_i::NIL },
@@ -176,8 +259,27 @@ namespace nightglow::lang
         { "void", token_i::VOID },
         { "auto", token_i::AUTO },
         { "Unique", token_i::UNIQUE },
-        { "Shared", token_i::SHARED },
+        { "Shared", token_i::SHARED }
+    }));
 
+    /**
+     * @brief Annotation names without the leading '@'.
+     */
+    inline constexpr auto annotation_table = sort_token_table(std::to_array<token_entry>({
+        { "align", token_i::ALIGN_ANNOT },
+        { "deprecated", token_i::DEPRECATED_ANNOT },
+        { "packed", token_i::PACKED_ANNOT },
+        { "nodiscard", token_i::NO_DISCARD_ANNOT },
+        { "volatile", token_i::VOLATILE_ANNOT },
+        { "lazy", token_i::LAZY_ANNOT },
+        { "pure", token_i::PURE_ANNOT },
+        { "tailrec", token_i::TAIL_REC_ANNOT }
+    }));
+
+    /**
+     * @brief Operators and punctuation, matched longest first by the lexer.
+     */
+    inline constexpr auto operator_table = sort_token_table(std::to_array<token_entry>({
         { "+", token_i::PLUS },
         { "-", token_i::MINUS },
         { "*", token_i::STAR },
@@ -212,15 +314,6 @@ namespace nightglow::lang
         { "->", token_i::ARROW },
         { ".", token_i::DOT },
 
-        { "align", token_i::ALIGN_ANNOT },
-        { "deprecated", token_i::DEPRECATED_ANNOT },
-        { "packed", token_i::PACKED_ANNOT },
-        { "nodiscard", token_i::NO_DISCARD_ANNOT },
-        { "volatile", token_i::VOLATILE_ANNOT },
-        { "lazy", token_i::LAZY_ANNOT },
-        { "pure", token_i::PURE_ANNOT },
-        { "tailrec", token_i::TAIL_REC_ANNOT },
-
         { "(", token_i::LEFT_PAREN },
         { ")", token_i::RIGHT_PAREN },
         { "{", token_i::LEFT_BRACE },
@@ -231,7 +324,20 @@ namespace nightglow::lang
         { ":", token_i::COLON },
         { ";", token_i::SEMICOLON },
         { "?", token_i::QUESTION }
-    };
+    }));
+
+    /**
+     * @brief Looks up a token in one of the constant token tables.
+     * @param table The sorted table to search.
+     * @param text The text to look up.
+     * @return token_i The matching token type, or token_i::UNKNOWN if the text is not in the table.
+     */
+    template<size_t N>
+    constexpr token_i lookup_token(const std::array<token_entry, N>& table, const std::string_view text)
+    {
+        const auto it = std::ranges::lower_bound(table, text, {}, &token_entry::text);
+        return it != table.end() && it->text == text ? it->type : token_i::UNKNOWN;
+    }
 
     /**
      * @brief Represents a token that the lexer has found.
@@ -244,23 +350,169 @@ namespace nightglow::lang
         uint8_t flags;
     };
 
+    static_assert(sizeof(token_t) == 8);
+
+    /**
+     * @brief Layout policy that stores every token field in its own column. Best for scans that read one field.
+     */
+    struct soa_layout {};
+
     /**
-     * @brief A structure to efficiently store tokens.
+     * @brief Layout policy that stores packed 8-byte token_t records. Best for consumers that read whole tokens.
      */
-    struct alignas(8) TokenList
+    struct aos_layout {};
+
+    /**
+     * @brief Layout policy that stores columns in blocks of 8 tokens, one cache line per block.
+     */
+    struct aosoa_layout
     {
-        std::vector<uint32_t> starts;
-        std::vector<uint16_t> lengths;
-        std::vector<token_i> types;
-        std::vector<uint8_t> flags;
+        static constexpr uint32_t block_size = 8;
+    };
+
+    /**
+     * @brief A structure to efficiently store tokens, specialized per layout policy. Every layout provides
+     * push_back, reserve, size, operator[] and the per-field accessors start, length, type and flag.
+     */
+    template<typename Layout>
+    struct BasicTokenList;
+
+    /**
+     * @brief Entry of TokenList::matches for tokens that are not brackets, and for brackets without a partner.
+     */
+    inline constexpr uint32_t no_match = 0xFFFFFFFF;
+
+    /**
+     * @brief What a run of source between two tokens is. SKIPPED covers bytes the lexer dropped as unknown.
+     */
+    enum class trivia_kind : uint8_t
+    {
+        WHITESPACE,
+        LINE_COMMENT,
+        BLOCK_COMMENT,
+        SKIPPED
+    };
+
+    /**
+     * @brief A run of trivia, attached to the token that follows it. Trivia at the end of the file belongs to
+     * the END_OF_FILE token.
+     */
+    struct trivia_t
+    {
+        uint32_t token;
+        uint32_t start;
+        uint32_t length;
+        trivia_kind kind;
+    };
+
+    template<>
+    struct alignas(8) BasicTokenList<soa_layout>
+    {
+        memory::vector<uint32_t> starts;
+        memory::vector<uint16_t> lengths;
+        memory::vector<token_i> types;
+        memory::vector<uint8_t> flags;
+
+        /**
+         * @brief For each (, { and [ the index of its closer and vice versa. Filled by tokenize() only when
+         * LexerState::match_brackets is set, and empty otherwise.
+         */
+        memory::vector<uint32_t> matches;
+
+        /**
+         * @brief Indices of brackets without a partner of the same kind, in token order. Filled along with matches.
+         */
+        memory::vector<uint32_t> unmatched;
+
+        /**
+         * @brief The whitespace, comments and skipped bytes of the source, in source order. Filled by tokenize()
+         * only when LexerState::keep_trivia is set, and empty otherwise.
+         */
+        memory::vector<trivia_t> trivia;
 
         void push_back(const token_t& token);
-        void reserve(const uint32_t& n);
+        void reserve(const uint32_t& n = 10000);
+        void clear();
         [[nodiscard]] size_t size() const
         {
             return starts.size();
         }
+
+        [[nodiscard]] token_t operator[](const size_t i) const
+        {
+            return { starts[i], lengths[i], types[i], flags[i] };
+        }
+        [[nodiscard]] uint32_t start(const size_t i) const { return starts[i]; }
+        [[nodiscard]] uint16_t length(const size_t i) const { return lengths[i]; }
+        [[nodiscard]] token_i type(const size_t i) const { return types[i]; }
+        [[nodiscard]] uint8_t flag(const size_t i) const { return flags[i]; }
     };
+
+    template<>
+    struct alignas(8) BasicTokenList<aos_layout>
+    {
+        memory::vector<token_t> records;
+
+        void push_back(const token_t& token);
+        void reserve(const uint32_t& n = 10000);
+        void clear();
+        [[nodiscard]] size_t size() const
+        {
+            return records.size();
+        }
+
+        [[nodiscard]] token_t operator[](const size_t i) const
+        {
+            return records[i];
+        }
+        [[nodiscard]] uint32_t start(const size_t i) const { return records[i].start; }
+        [[nodiscard]] uint16_t length(const size_t i) const { return records[i].length; }
+        [[nodiscard]] token_i type(const size_t i) const { return records[i].type; }
+        [[nodiscard]] uint8_t flag(const size_t i) const { return records[i].flags; }
+    };
+
+    template<>
+    struct alignas(8) BasicTokenList<aosoa_layout>
+    {
+        static constexpr uint32_t block_size = aosoa_layout::block_size;
+
+        struct alignas(64) block
+        {
+            uint32_t starts[block_size];
+            uint16_t lengths[block_size];
+            token_i types[block_size];
+            uint8_t flags[block_size];
+        };
+
+        memory::vector<block> blocks;
+        uint32_t count{};
+
+        void push_back(const token_t& token);
+        void reserve(const uint32_t& n = 10000);
+        void clear();
+        [[nodiscard]] size_t size() const
+        {
+            return count;
+        }
+
+        [[nodiscard]] token_t operator[](const size_t i) const
+        {
+            const block& b = blocks[i / block_size];
+            const size_t j = i % block_size;
+            return { b.starts[j], b.lengths[j], b.types[j], b.flags[j] };
+        }
+        [[nodiscard]] uint32_t start(const size_t i) const { return blocks[i / block_size].starts[i % block_size]; }
+        [[nodiscard]] uint16_t length(const size_t i) const { return blocks[i / block_size].lengths[i % block_size]; }
+        [[nodiscard]] token_i type(const size_t i) const { return blocks[i / block_size].types[i % block_size]; }
+        [[nodiscard]] uint8_t flag(const size_t i) const { return blocks[i / block_size].flags[i % block_size]; }
+    };
+
+    static_assert(sizeof(BasicTokenList<aosoa_layout>::block) == 64);
+
+    /**
+     * @brief The default token storage used by the lexer and the rest of the frontend.
+     */
+    using TokenList = BasicTokenList<soa_layout>;
 }
 
 #endif
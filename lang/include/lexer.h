@@ -11,52 +11,93 @@
 namespace nightglow::lang::lexer
 {
     /**
-     * @brief The lexer class.
+     * @brief Version of the token stream the lexer produces. Bump whenever tokenize() output changes for the same input.
+     */
+    inline constexpr uint32_t lexer_version = 3;
+
+    /**
+     * @brief Source bytes per token assumed when tokenize() reserves the token list. Typical code averages
+     * 3-7 bytes per token; denser input just grows the list once.
+     */
+    inline constexpr uint32_t expected_bytes_per_token = 4;
+
+    /**
+     * @brief The scanning state of the lexer, independent of how tokens are stored.
      */
-     struct alignas(8) Lexer
+     struct alignas(8) LexerState
      {
         const char* src{};
-        TokenList tokens;
         uint32_t current_pos{};
         uint32_t src_length{};
-        std::vector<uint32_t> line_starts;
+        memory::vector<uint32_t> line_starts;
+        bool match_brackets{}; // set before tokenize() to fill TokenList::matches (SoA layout only)
+        bool keep_trivia{}; // set before tokenize() to fill TokenList::trivia (SoA layout only)
+     };
+
+    /**
+     * @brief The lexer class.
+     * @tparam Layout The token storage layout policy. soa_layout, aos_layout and aosoa_layout are supported.
+     */
+     template<typename Layout>
+     struct alignas(8) BasicLexer : LexerState
+     {
+        BasicTokenList<Layout> tokens;
      };
 
+     using Lexer = BasicLexer<soa_layout>;
+
     /**
      * @brief Creates a lexer object.
+     * @tparam Layout The token storage layout policy.
+     * @param src The source code to tokenize.
+     * @param length The length of the source code.
+     * @return BasicLexer<Layout> The lexer object.
+     * @throws std::runtime_error if the source file is too large (>4GiB).
+     */
+     template<typename Layout = soa_layout>
+     BasicLexer<Layout> create_lexer(std::string_view src, size_t length);
+
+    /**
+     * @brief Points an existing lexer at a new source, keeping the capacity of its token list and line starts.
+     * @tparam Layout The token storage layout policy.
+     * @param lexer The lexer object to reuse.
      * @param src The source code to tokenize.
      * @param length The length of the source code.
-     * @return Lexer The lexer object.
      * @throws std::runtime_error if the source file is too large (>4GiB).
      */
-     Lexer create_lexer(std::string_view src, size_t length);
+     template<typename Layout>
+     void reset_lexer(BasicLexer<Layout>& lexer, std::string_view src, size_t length);
 
     /**
      * @brief Peek the next token without advancing.
      * @param lexer The lexer object.
      * @return token_t The next token.
      */
-     token_t peek_next(const Lexer& lexer);
+     token_t peek_next(const LexerState& lexer);
 
     /**
-     * @brief Advances the lexer to the next token.
+     * @brief Advances the lexer past a token.
      * @param lexer The lexer object.
+     * @param token The token that was just lexed.
      */
-     inline void advance(Lexer& lexer);
+     void advance(LexerState& lexer, const token_t& token);
 
     /**
      * @brief Returns the next token.
      * @param lexer The lexer object.
      * @return token_t The next token.
+     * @throws std::runtime_error if a token is longer than 65535 bytes.
      */
-     token_t next_token(Lexer& lexer);
+     token_t next_token(LexerState& lexer);
 
     /**
-     * @brief Tokenizes the source code and returns the token type.
+     * @brief Tokenizes the source code into the lexer's token list.
      * @param lexer The lexer object.
-     * @return token_i The token type.
+     * @return BasicTokenList<Layout>* The tokens.
+     * @throws std::runtime_error if a token is longer than 65535 bytes.
      */
-     TokenList* tokenize(Lexer& lexer);
+     template<typename Layout>
+     BasicTokenList<Layout>* tokenize(BasicLexer<Layout>& lexer);
 
     /**
      * @brief Skips whitespace and comments using SIMD instructions.
@@ -65,7 +106,7 @@ namespace nightglow::lang::lexer
      * @param current_pos The current position in the source code.
      * @param src_length The length of the source code.
      */
-     void skip_whitespace_comment(Lexer& lexer, const char *src, uint32_t &current_pos, uint32_t src_length);
+     void skip_whitespace_comment(LexerState& lexer, const char *src, uint32_t &current_pos, uint32_t src_length);
 
     /**
      * @brief Get the line and column for a given token.
@@ -73,7 +114,7 @@ namespace nightglow::lang::lexer
      * @param token The token.
      * @return std::pair<uint32_t, uint32_t> The line and column.
      */
-     std::pair<uint32_t, uint32_t> get_line_col(const Lexer& lexer, const token_t& token);
+     std::pair<uint32_t, uint32_t> get_line_col(const LexerState& lexer, const token_t& token);
 
     /**
      * @brief Get the string value of a token.
@@ -81,28 +122,31 @@ namespace nightglow::lang::lexer
      * @param token The token.
      * @return std::string_view The string value of the token.
      */
-     std::string_view get_token_value(const Lexer& lexer, const token_t& token);
+     std::string_view get_token_value(const LexerState& lexer, const token_t& token);
 
     /**
      * @brief Checks if the token is a keyword or an identifier or a type.
      * @param lexer The lexer object.
      * @return token_t The token type.
+     * @throws std::runtime_error if the identifier is longer than 65535 bytes.
      */
-     token_t lex_identifier(const Lexer& lexer);
+     token_t lex_identifier(const LexerState& lexer);
 
     /**
      * @brief Checks if the token is a number literal. Allows for floating point numbers, hexadecimals, and binary numbers.
      * @param lexer The lexer object.
      * @return token_t The token type.
+     * @throws std::runtime_error if the literal is longer than 65535 bytes.
      */
-     token_t lex_number(const Lexer& lexer);
+     token_t lex_number(const LexerState& lexer);
 
      /**
       * @brief Checks if the token is a string literal. Allows for escape sequences.
       * @param lexer The lexer object.
       * @return token_t The token type.
+      * @throws std::runtime_error if the literal is longer than 65535 bytes.
       */
-      token_t lex_string(const Lexer& lexer);
+      token_t lex_string(const LexerState& lexer);
 }
 
 #endif
\ No newline at end of file
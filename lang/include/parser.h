@@ -0,0 +1,275 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <string>
+#include "ast.h"
+
+namespace nightglow::lang::parser
+{
+    /**
+     * @brief How strongly an infix or postfix operator binds to its operands. An operator extends the expression
+     * to its left only if its left power is greater than the right power of the operator it would be nested in,
+     * so right < left makes an operator right associative.
+     */
+    struct infix_rule
+    {
+        uint8_t left;
+        uint8_t right;
+        ast::node_kind kind;
+    };
+
+    /**
+     * @brief Right binding power of prefix operators: tighter than every binary operator, looser than postfix ones.
+     */
+    inline constexpr uint8_t prefix_power = 27;
+
+    /**
+     * @brief Infix and postfix rules indexed by token_i. A left power of 0 means the token is not an infix operator.
+     */
+    inline constexpr auto infix_rules = []
+    {
+        std::array<infix_rule, static_cast<size_t>(token_i::END_OF_FILE) + 1> rules{};
+        const auto set = [&rules](const token_i type, const uint8_t left, const uint8_t right, const ast::node_kind kind)
+        {
+            rules[static_cast<size_t>(type)] = { left, right, kind };
+        };
+
+        for (const token_i type : { token_i::EQUAL, token_i::PLUS_EQUAL, token_i::MINUS_EQUAL, token_i::STAR_EQUAL, token_i::SLASH_EQUAL,
+                                    token_i::PERCENT_EQUAL, token_i::AND_EQUAL, token_i::OR_EQUAL, token_i::XOR_EQUAL,
+                                    token_i::LEFT_SHIFT_EQUAL, token_i::RIGHT_SHIFT_EQUAL })
+        {
+            set(type, 2, 1, ast::node_kind::ASSIGN);
+        }
+        set(token_i::QUESTION, 4, 3, ast::node_kind::CONDITIONAL);
+        set(token_i::OR_OR, 6, 7, ast::node_kind::BINARY);
+        set(token_i::AND_AND, 8, 9, ast::node_kind::BINARY);
+        set(token_i::OR, 10, 11, ast::node_kind::BINARY);
+        set(token_i::XOR, 12, 13, ast::node_kind::BINARY);
+        set(token_i::AND, 14, 15, ast::node_kind::BINARY);
+        for (const token_i type : { token_i::EQUAL_EQUAL, token_i::BANG_EQUAL })
+            set(type, 16, 17, ast::node_kind::BINARY);
+        for (const token_i type : { token_i::LESS, token_i::LESS_EQUAL, token_i::GREATER, token_i::GREATER_EQUAL })
+            set(type, 18, 19, ast::node_kind::BINARY);
+        for (const token_i type : { token_i::LEFT_SHIFT, token_i::RIGHT_SHIFT })
+            set(type, 20, 21, ast::node_kind::BINARY);
+        for (const token_i type : { token_i::PLUS, token_i::MINUS })
+            set(type, 22, 23, ast::node_kind::BINARY);
+        for (const token_i type : { token_i::STAR, token_i::SLASH, token_i::PERCENT })
+            set(type, 24, 25, ast::node_kind::BINARY);
+        set(token_i::LEFT_PAREN, 30, 0, ast::node_kind::CALL);
+        set(token_i::LEFT_BRACKET, 30, 0, ast::node_kind::INDEX);
+        set(token_i::DOT, 30, 0, ast::node_kind::MEMBER);
+        return rules;
+    }();
+
+    /**
+     * @brief Tokens that start a prefix operation, indexed by token_i.
+     */
+    inline constexpr auto prefix_operators = []
+    {
+        std::array<bool, static_cast<size_t>(token_i::END_OF_FILE) + 1> prefix{};
+        for (const token_i type : { token_i::PLUS, token_i::MINUS, token_i::BANG, token_i::TILDE, token_i::NEW, token_i::AWAIT })
+        {
+            prefix[static_cast<size_t>(type)] = true;
+        }
+        return prefix;
+    }();
+
+    constexpr const infix_rule& infix_rule_of(const token_i type)
+    {
+        return infix_rules[static_cast<size_t>(type)];
+    }
+
+    /**
+     * @brief An operator or bracket whose operands are still being parsed. Expressions are parsed with an
+     * explicit stack of these, so nesting depth never turns into native stack depth.
+     */
+    struct expression_frame
+    {
+        enum : uint8_t
+        {
+            BOTTOM,
+            PREFIX,
+            INFIX,
+            GROUP,
+            CALL,
+            INDEX,
+            CONDITION_THEN,
+            CONDITION_ELSE
+        } kind;
+        uint8_t power;
+        uint32_t token;
+        uint32_t begin;
+        uint32_t value_base;
+    };
+
+    /**
+     * @brief Switches that trade completeness of the tree for parse time.
+     */
+    struct parse_options
+    {
+        /**
+         * @brief Record function bodies as LAZY_BLOCK nodes covering their braces instead of parsing them.
+         * Syntax errors inside a body are reported when it is materialized.
+         */
+        bool lazy_bodies = false;
+
+        /**
+         * @brief Threads that parse top-level declarations in parallel; 0 means one per hardware thread.
+         * The tree is the same as with a single thread, node for node.
+         */
+        uint32_t threads = 1;
+    };
+
+    /**
+     * @brief Fewest tokens worth handing to a parser thread of its own.
+     */
+    inline constexpr uint32_t min_tokens_per_thread = 16384;
+
+    /**
+     * @brief A run of tokens, as indices [begin, end) into a TokenList.
+     */
+    struct token_range
+    {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    /**
+     * @brief The parser state. Reads the token columns of a tokenized lexer and appends to an Ast.
+     * After a syntax error the parser is recovering: further errors are not recorded and constructs return as soon
+     * as they can, until the enclosing statement list skips to a synchronization point and clears the flag.
+     */
+    struct Parser
+    {
+        const lexer::LexerState* lexer{};
+        const TokenList* tokens{};
+        uint32_t pos{};
+        bool recovering{};
+        parse_options options;
+        ast::Ast ast;
+        memory::vector<ast::node_id> scratch;
+        memory::vector<ast::node_id> values;
+        memory::vector<expression_frame> frames;
+
+        [[nodiscard]] token_i peek() const
+        {
+            return tokens->types[pos];
+        }
+
+        [[nodiscard]] token_i peek(const uint32_t ahead) const
+        {
+            const size_t at = std::min<size_t>(pos + ahead, tokens->size() - 1);
+            return tokens->types[at];
+        }
+    };
+
+    /**
+     * @brief Creates a parser over a tokenized lexer. The lexer must outlive the parser.
+     * @param lexer The lexer object, after tokenize() has been called.
+     * @param options The parse options.
+     * @return Parser The parser object, positioned at the first token.
+     */
+    Parser create_parser(const lexer::Lexer& lexer, const parse_options& options = {});
+
+    /**
+     * @brief Parses a whole source file: leading imports, then declarations and statements until END_OF_FILE.
+     * Never throws on bad input: syntax errors are recorded in the tree's errors, in token order, and after each
+     * one the parser skips to the next ; or }, or to a function, class, var or const, so the tree is always complete.
+     * @param lexer The lexer object, after tokenize() has been called.
+     * @param options The parse options.
+     * @return ast::Ast The tree. Its root is a MODULE node.
+     */
+    ast::Ast parse(const lexer::Lexer& lexer, const parse_options& options = {});
+
+    /**
+     * @brief What a parse did.
+     */
+    struct parse_stats
+    {
+        uint32_t runs; // runs parsed on threads of their own and merged; 1 when the module was parsed serially
+    };
+
+    /**
+     * @brief Parses a whole source file like parse(), and reports how.
+     * @param lexer The lexer object, after tokenize() has been called.
+     * @param options The parse options.
+     * @param stats Set to what the parse did; runs is 1 after a parallel parse fell back to a serial one.
+     * @return ast::Ast The tree. Its root is a MODULE node.
+     */
+    ast::Ast parse(const lexer::Lexer& lexer, const parse_options& options, parse_stats& stats);
+
+    /**
+     * @brief Splits the top-level statements from a token on into at most parts runs of whole statements with
+     * similar token counts. A statement ends at a ; or } that closes every bracket opened since its start,
+     * unless an else follows. Jumps over groups through TokenList::matches when the lexer filled it.
+     * @param tokens The tokens of a file.
+     * @param begin The first token of the first statement, i.e. past the leading imports.
+     * @param parts The most runs to return.
+     * @return memory::vector<token_range> The runs in source order, ending at the END_OF_FILE token.
+     */
+    memory::vector<token_range> split_declarations(const TokenList& tokens, uint32_t begin, uint32_t parts);
+
+    /**
+     * @brief Parses the body of a function that was parsed with lazy_bodies and links it in place of its LAZY_BLOCK.
+     * Nodes are appended to the tree, so existing handles stay valid.
+     * @param ast The tree the function belongs to.
+     * @param lexer The lexer the tree was parsed from.
+     * @param function The FUNCTION node.
+     * @return ast::node_id The BLOCK node of the body, or no_node if the function has no body.
+     * Syntax errors in the body are appended to the tree's errors.
+     */
+    ast::node_id materialize_body(ast::Ast& ast, const lexer::Lexer& lexer, ast::node_id function);
+
+    /**
+     * @brief Formats a syntax error as "line:col: expected X, found TYPE 'text'".
+     * @param lexer The lexer the tree was parsed from.
+     * @param error The error.
+     * @return std::string The message.
+     */
+    std::string format_error(const lexer::Lexer& lexer, const ast::syntax_error& error);
+
+    /**
+     * @brief Parses the module at the parser position and sets it as the root.
+     */
+    ast::node_id parse_module(Parser& parser);
+
+    /**
+     * @brief Parses statements onto parser.scratch until close, END_OF_FILE or the end token, and after each one
+     * that failed skips to a synchronization point, covering the skipped tokens with an ERROR node.
+     * @param parser The parser object.
+     * @param close The token that ends the list, e.g. RIGHT_BRACE in a block. Not consumed.
+     * @param end The token index to stop at.
+     */
+    void parse_statements(Parser& parser, token_i close, uint32_t end = no_match);
+
+    /**
+     * @brief Parses a declaration (function, class, enum or variable, with annotations and modifiers) or a statement.
+     */
+    ast::node_id parse_statement(Parser& parser);
+
+    /**
+     * @brief Parses a braced block.
+     */
+    ast::node_id parse_block(Parser& parser);
+
+    /**
+     * @brief Parses a type: a primitive type or a dotted name, optionally followed by [] and ?.
+     */
+    ast::node_id parse_type(Parser& parser);
+
+    /**
+     * @brief Parses an expression with a Pratt loop driven by infix_rules.
+     * @param parser The parser object.
+     * @param min_power Only operators with a greater left binding power are taken.
+     * @return ast::node_id The expression node.
+     */
+    ast::node_id parse_expression(Parser& parser, uint8_t min_power = 0);
+}
+
+#endif
@@ -0,0 +1,98 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace nightglow::lang::perf
+{
+    /**
+     * @brief The hardware events counted around a phase.
+     */
+    enum class event : uint8_t
+    {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        LLC_MISSES
+    };
+
+    inline constexpr size_t event_count = 5;
+
+    inline constexpr std::array<std::string_view, event_count> event_names = {
+        "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"
+    };
+
+    /**
+     * @brief Counter values of one measurement. Values are scaled up if the kernel had to multiplex the counters.
+     */
+    struct counts
+    {
+        std::array<uint64_t, event_count> values{};
+        std::array<bool, event_count> valid{};
+
+        [[nodiscard]] uint64_t operator[](const event e) const
+        {
+            return values[static_cast<size_t>(e)];
+        }
+
+        [[nodiscard]] bool has(const event e) const
+        {
+            return valid[static_cast<size_t>(e)];
+        }
+
+        counts& operator+=(const counts& other);
+    };
+
+    /**
+     * @brief A set of perf_event counters on the calling thread, user space only. Events the kernel or
+     * the hardware does not provide are left out; on other platforms nothing is available.
+     */
+    struct Counters
+    {
+        std::array<int, event_count> fds{ -1, -1, -1, -1, -1 };
+        std::string error;
+
+        Counters();
+        ~Counters();
+        Counters(const Counters&) = delete;
+        Counters& operator=(const Counters&) = delete;
+
+        /**
+         * @brief Checks whether at least one event could be opened. If not, error says why.
+         */
+        [[nodiscard]] bool available() const;
+
+        /**
+         * @brief Resets and starts every open counter.
+         */
+        void start();
+
+        /**
+         * @brief Stops the counters and reads them.
+         * @return counts The values since start().
+         */
+        counts stop();
+    };
+
+    /**
+     * @brief Prints the counts of a phase as totals, per-byte and per-token ratios, plus IPC.
+     * @param out The stream to print to.
+     * @param phase The phase name, e.g. "tokenize".
+     * @param c The counts.
+     * @param bytes The source bytes processed by the phase.
+     * @param tokens The tokens produced by the phase, or 0 if it produces none.
+     */
+    void print_report(std::ostream& out, std::string_view phase, const counts& c, uint64_t bytes, uint64_t tokens);
+}
+
+#endif
@@ -0,0 +1,122 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include "lexer.h"
+
+namespace nightglow::lang::pipeline
+{
+    /**
+     * @brief Number of tokens published at once. A full batch is 8KiB, small enough to still be in cache when consumed.
+     */
+    inline constexpr uint32_t batch_size = 1024;
+
+    /**
+     * @brief Number of batches in flight. The lexer blocks once it is this far ahead of the consumer.
+     */
+    inline constexpr uint32_t ring_capacity = 8;
+
+    /**
+     * @brief A batch of tokens handed from the lexer thread to the consumer. The last batch ends with END_OF_FILE.
+     */
+    struct alignas(64) token_batch
+    {
+        token_t tokens[batch_size];
+        uint32_t size;
+        bool last;
+    };
+
+    /**
+     * @brief A lock-free single-producer single-consumer ring of token batches. Batches are filled in place.
+     */
+    struct TokenRing
+    {
+        token_batch slots[ring_capacity];
+        alignas(64) std::atomic<uint32_t> head{};
+        alignas(64) std::atomic<uint32_t> tail{};
+        alignas(64) std::atomic<bool> stop{};
+
+        /**
+         * @brief Producer side. Waits for a free slot and returns it without publishing it.
+         */
+        token_batch& acquire();
+
+        /**
+         * @brief Producer side. Publishes the slot returned by acquire().
+         */
+        void publish();
+
+        /**
+         * @brief Consumer side. Waits for the next published batch.
+         */
+        const token_batch& front();
+
+        /**
+         * @brief Consumer side. Hands the batch returned by front() back to the producer.
+         */
+        void release();
+    };
+
+    /**
+     * @brief Lexes the source into the ring until END_OF_FILE or until ring.stop is set. Runs on the lexer thread.
+     * @param lexer The lexer object.
+     * @param ring The ring to publish into.
+     * @param error Receives any exception thrown while lexing. A final empty batch is still published.
+     */
+    void produce(lexer::LexerState& lexer, TokenRing& ring, std::exception_ptr& error);
+
+    /**
+     * @brief Lexes on a separate thread while the calling thread consumes token batches as they are published.
+     * The lexer (including line_starts) belongs to the lexer thread until run() returns.
+     * @param lexer The lexer object, as returned by create_lexer().
+     * @param consume Callable taking a const token_batch&. Called in source order on the calling thread.
+     * @throws Rethrows any exception thrown by the lexer or the consumer once both threads have stopped.
+     */
+    template<typename Consumer>
+    void run(lexer::LexerState& lexer, Consumer&& consume)
+    {
+        const auto ring = std::make_unique<TokenRing>();
+        std::exception_ptr lexer_error;
+        std::exception_ptr consumer_error;
+        std::thread producer([&lexer, &ring, &lexer_error] { produce(lexer, *ring, lexer_error); });
+
+        while (true)
+        {
+            const token_batch& batch = ring->front();
+            if (!consumer_error)
+            {
+                try
+                {
+                    consume(batch);
+                }
+                catch (...)
+                {
+                    // keep draining so the lexer thread is never left blocked on a full ring
+                    consumer_error = std::current_exception();
+                    ring->stop.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            const bool last = batch.last;
+            ring->release();
+            if (last)
+                break;
+        }
+
+        producer.join();
+        if (consumer_error)
+            std::rethrow_exception(consumer_error);
+        if (lexer_error)
+            std::rethrow_exception(lexer_error);
+    }
+}
+
+#endif
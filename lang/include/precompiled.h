@@ -0,0 +1,251 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef PRECOMPILED_H
+#define PRECOMPILED_H
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include "ast.h"
+
+namespace nightglow::lang::precompiled
+{
+    /**
+     * @brief Version of the on-disk layout. Bump when module_header or a record layout changes.
+     */
+    inline constexpr uint32_t format_version = 2;
+
+    /**
+     * @brief Every table in a module file starts on this boundary.
+     */
+    inline constexpr uint32_t table_alignment = 64;
+
+    inline constexpr uint32_t no_decl = 0xFFFFFFFF;
+
+    /**
+     * @brief A string in the interned string pool, as a byte range.
+     */
+    struct string_ref
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /**
+     * @brief Modifiers and markers of a declaration.
+     */
+    enum decl_flags : uint16_t
+    {
+        PUBLIC = 1 << 0,
+        PROTECTED = 1 << 1,
+        FINAL = 1 << 2,
+        INLINE = 1 << 3,
+        ASYNC = 1 << 4,
+        CONSTANT = 1 << 5,
+        HAS_BODY = 1 << 6
+    };
+
+    /**
+     * @brief An exported declaration. Members of classes and enumerators of enums follow their parent.
+     * type is the return type of a function, the declared type of a variable and the base of a class; empty if none.
+     * Parameters and annotations are ranges of the params and annotations tables.
+     */
+    struct decl_record
+    {
+        string_ref name;
+        string_ref type;
+        uint32_t parent;
+        uint32_t first_param;
+        uint32_t param_count;
+        uint32_t first_annotation;
+        uint32_t annotation_count;
+        uint32_t line;
+        ast::node_kind kind;
+        uint8_t reserved;
+        uint16_t flags;
+    };
+
+    struct param_record
+    {
+        string_ref name;
+        string_ref type;
+        uint32_t has_default;
+    };
+
+    /**
+     * @brief The exported interface of a module: its imports and declarations with their signatures, in
+     * pointer-free tables that are written to disk as they are. Names, types and annotations are interned in one
+     * string pool; imports are dotted module names.
+     */
+    struct Interface
+    {
+        memory::vector<decl_record> decls;
+        memory::vector<param_record> params;
+        memory::vector<string_ref> annotations;
+        memory::vector<string_ref> imports;
+        std::string strings;
+        memory::vector<string_ref> slots; // open addressing table over the pool; free slots have offset no_decl
+        uint32_t interned{};
+
+        /**
+         * @brief Adds a string to the pool once and returns where it is.
+         */
+        string_ref intern(std::string_view text);
+
+        [[nodiscard]] std::string_view string(const string_ref ref) const
+        {
+            return { strings.data() + ref.offset, ref.length };
+        }
+    };
+
+    /**
+     * @brief The fixed header at the start of every module file. All offsets are relative to the start of the file.
+     */
+    struct alignas(8) module_header
+    {
+        char magic[8];
+        uint32_t endian_tag;
+        uint32_t format_version;
+        uint32_t source_length;
+        uint32_t decl_count;
+        uint64_t source_hash;
+        uint32_t param_count;
+        uint32_t annotation_count;
+        uint32_t export_count;
+        uint32_t string_bytes;
+        uint32_t import_count;
+        uint32_t reserved;
+        uint64_t decls_offset;
+        uint64_t params_offset;
+        uint64_t annotations_offset;
+        uint64_t exports_offset;
+        uint64_t imports_offset;
+        uint64_t strings_offset;
+    };
+
+    /**
+     * @brief One declaration of a mapped module with its strings resolved. The views point into the mapping.
+     */
+    struct declaration
+    {
+        struct parameter
+        {
+            std::string_view name;
+            std::string_view type;
+            bool has_default;
+        };
+
+        ast::node_kind kind;
+        std::string_view name;
+        std::string_view type;
+        uint16_t flags;
+        uint32_t line;
+        uint32_t parent;
+        memory::vector<parameter> params;
+        memory::vector<std::string_view> annotations;
+    };
+
+    /**
+     * @brief A read-only view of a module file, backed by a single mapping. Loading checks the header and the
+     * table bounds only; declarations are materialized one at a time, on request.
+     */
+    struct MappedModule
+    {
+        void* base{};
+        size_t mapped_size{};
+        std::span<const decl_record> decls;
+        std::span<const param_record> params;
+        std::span<const string_ref> annotations;
+        std::span<const uint32_t> exports; // top-level declarations, sorted by name
+        std::span<const string_ref> imports;
+        std::string_view strings;
+
+        MappedModule() = default;
+        MappedModule(MappedModule&& other) noexcept;
+        MappedModule& operator=(MappedModule&& other) noexcept;
+        MappedModule(const MappedModule&) = delete;
+        MappedModule& operator=(const MappedModule&) = delete;
+        ~MappedModule();
+
+        [[nodiscard]] std::string_view string(const string_ref ref) const
+        {
+            return ref.offset <= strings.size() ? strings.substr(ref.offset, ref.length) : std::string_view{};
+        }
+
+        /**
+         * @brief Finds a top-level declaration by name with a binary search over the exports table.
+         * @return uint32_t The index of the declaration, or no_decl.
+         */
+        [[nodiscard]] uint32_t find(std::string_view name) const;
+
+        /**
+         * @brief Resolves the strings, parameters and annotations of one declaration.
+         * @param index The index of the declaration.
+         * @return declaration The declaration, or an empty one of kind ERROR with parent no_decl if the index is out
+         * of range, as no_decl from find() is.
+         */
+        [[nodiscard]] declaration materialize(uint32_t index) const;
+    };
+
+    /**
+     * @brief Collects the imports and exported declarations of a parsed module: top-level functions, classes,
+     * enums and variables, the members of classes and the enumerators of enums. Private members are left out.
+     * Works on trees parsed with lazy_bodies, since bodies are not looked at.
+     * @param lexer The lexer the tree was parsed from.
+     * @param ast The tree.
+     * @return Interface The interface.
+     */
+    Interface extract(const lexer::Lexer& lexer, const ast::Ast& ast);
+
+    /**
+     * @brief Collects the same interface as extract() straight from the tokens, without parsing. Declarations are
+     * recognized by their keywords; bodies, initializers and default values are stepped over as bracket groups,
+     * so no expression is ever built. Uses TokenList::matches when the lexer matched brackets.
+     * For a module without syntax errors the result equals that of extract(); for a broken one it is a best
+     * effort and never reads past the end of the tokens.
+     * @param lexer The lexer, after tokenize() has been called.
+     * @return Interface The interface.
+     */
+    Interface scan(const lexer::Lexer& lexer);
+
+    /**
+     * @brief Gets the module file path for a source. The name is derived from the source hash and the format version.
+     * @param dir The module directory.
+     * @param src The source code.
+     * @return std::filesystem::path The path of the module file.
+     */
+    std::filesystem::path module_path(const std::filesystem::path& dir, std::string_view src);
+
+    /**
+     * @brief Writes an interface to a file in the module format. The file is written atomically.
+     * @param path The file to write.
+     * @param exported The interface.
+     * @param src The source code the interface was extracted from.
+     * @return bool True if the file was written.
+     */
+    bool write(const std::filesystem::path& path, const Interface& exported, std::string_view src);
+
+    /**
+     * @brief Extracts the interface of a parsed module and writes it to the module directory. Modules with syntax
+     * errors are not written, so a stale file is never mistaken for a good one.
+     * @param dir The module directory. Created if it does not exist.
+     * @param lexer The lexer the tree was parsed from.
+     * @param ast The tree.
+     * @return bool True if the module file was written.
+     */
+    bool store(const std::filesystem::path& dir, const lexer::Lexer& lexer, const ast::Ast& ast);
+
+    /**
+     * @brief Maps the module file of a source, if there is a valid one.
+     * @param dir The module directory.
+     * @param src The source code.
+     * @return std::optional<MappedModule> The mapped module, or std::nullopt on a miss or a stale/corrupt file.
+     */
+    std::optional<MappedModule> load(const std::filesystem::path& dir, std::string_view src);
+}
+
+#endif
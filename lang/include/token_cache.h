@@ -0,0 +1,119 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include "lexer.h"
+
+namespace nightglow::lang::cache
+{
+    /**
+     * @brief Version of the on-disk layout. Bump when cache_header or the column layout changes.
+     */
+    inline constexpr uint32_t format_version = 1;
+
+    /**
+     * @brief Every column in a cache file starts on this boundary.
+     */
+    inline constexpr uint32_t column_alignment = 64;
+
+    /**
+     * @brief The fixed header at the start of every cache file. All offsets are relative to the start of the file.
+     */
+    struct alignas(8) cache_header
+    {
+        char magic[8];
+        uint32_t endian_tag;
+        uint32_t format_version;
+        uint32_t lexer_version;
+        uint32_t source_length;
+        uint64_t source_hash;
+        uint32_t token_count;
+        uint32_t line_count;
+        uint64_t starts_offset;
+        uint64_t lengths_offset;
+        uint64_t types_offset;
+        uint64_t flags_offset;
+        uint64_t line_starts_offset;
+    };
+
+    /**
+     * @brief A read-only view of a cached token stream, backed by a single mapping of the cache file.
+     */
+    struct alignas(8) MappedTokens
+    {
+        void* base{};
+        size_t mapped_size{};
+        std::span<const uint32_t> starts;
+        std::span<const uint16_t> lengths;
+        std::span<const token_i> types;
+        std::span<const uint8_t> flags;
+        std::span<const uint32_t> line_starts;
+
+        MappedTokens() = default;
+        MappedTokens(MappedTokens&& other) noexcept;
+        MappedTokens& operator=(MappedTokens&& other) noexcept;
+        MappedTokens(const MappedTokens&) = delete;
+        MappedTokens& operator=(const MappedTokens&) = delete;
+        ~MappedTokens();
+
+        [[nodiscard]] size_t size() const
+        {
+            return starts.size();
+        }
+    };
+
+    /**
+     * @brief Hashes the source bytes.
+     * @param src The source code.
+     * @return uint64_t The hash of the source code.
+     */
+    uint64_t hash_source(std::string_view src);
+
+    /**
+     * @brief Gets the cache file path for a source. The name is derived from the source hash, the lexer version and the format version.
+     * @param dir The cache directory.
+     * @param src The source code.
+     * @return std::filesystem::path The path of the cache file.
+     */
+    std::filesystem::path cache_path(const std::filesystem::path& dir, std::string_view src);
+
+    /**
+     * @brief Writes the tokens and line starts of a tokenized lexer to a file in the cache format. The file is written atomically.
+     * @param path The file to write.
+     * @param lexer The lexer object, after tokenize() has been called.
+     * @return bool True if the file was written.
+     */
+    bool write(const std::filesystem::path& path, const lexer::Lexer& lexer);
+
+    /**
+     * @brief Writes the tokens and line starts of a tokenized lexer to the cache. The file is written atomically.
+     * @param dir The cache directory. Created if it does not exist.
+     * @param lexer The lexer object, after tokenize() has been called.
+     * @return bool True if the cache file was written.
+     */
+    bool store(const std::filesystem::path& dir, const lexer::Lexer& lexer);
+
+    /**
+     * @brief Maps the cached token stream of a source, if there is a valid one.
+     * @param dir The cache directory.
+     * @param src The source code.
+     * @return std::optional<MappedTokens> The mapped tokens, or std::nullopt on a miss or a stale/corrupt file.
+     */
+    std::optional<MappedTokens> load(const std::filesystem::path& dir, std::string_view src);
+
+    /**
+     * @brief Copies a mapped token stream into an owning TokenList.
+     * @param mapped The mapped tokens.
+     * @return TokenList The copied tokens.
+     */
+    TokenList to_token_list(const MappedTokens& mapped);
+}
+
+#endif
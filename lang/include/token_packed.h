@@ -0,0 +1,107 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef TOKEN_PACKED_H
+#define TOKEN_PACKED_H
+
+#include "lang.h"
+
+namespace nightglow::lang::packed
+{
+    /**
+     * @brief Number of tokens per compressed block. Every block decodes independently.
+     */
+    inline constexpr uint32_t block_size = 128;
+
+    /**
+     * @brief Describes one compressed block. Each column is bit-packed with its own width in a
+     * 4-lane vertical layout, so a width of w bits occupies exactly 4 * w words of the payload.
+     */
+    struct block_header
+    {
+        uint32_t first_start;
+        uint32_t word_offset;
+        uint8_t gap_bits;
+        uint8_t length_bits;
+        uint8_t type_bits;
+        uint8_t flag_bits;
+    };
+
+    /**
+     * @brief A compressed, read-only token stream. Starts are stored as the gap from the end of
+     * the previous token, which is almost always 0 or 1.
+     */
+    struct alignas(16) PackedTokenList
+    {
+        memory::vector<block_header> blocks;
+        memory::vector<uint32_t> words;
+        uint32_t count{};
+
+        [[nodiscard]] size_t size() const
+        {
+            return count;
+        }
+
+        /**
+         * @brief Bytes held by the compressed representation.
+         */
+        [[nodiscard]] size_t memory_usage() const
+        {
+            return blocks.capacity() * sizeof(block_header) + words.capacity() * sizeof(uint32_t);
+        }
+    };
+
+    /**
+     * @brief A decoded block of tokens, laid out like the columns of TokenList.
+     */
+    struct alignas(16) token_block
+    {
+        uint32_t starts[block_size];
+        uint16_t lengths[block_size];
+        token_i types[block_size];
+        uint8_t flags[block_size];
+        uint32_t size;
+    };
+
+    /**
+     * @brief Compresses a token list.
+     * @param tokens The tokens to compress.
+     * @return PackedTokenList The compressed tokens.
+     */
+    PackedTokenList compress(const TokenList& tokens);
+
+    /**
+     * @brief Decodes a single block using SIMD bit unpacking where available.
+     * @param packed The compressed tokens.
+     * @param index The block index, less than packed.blocks.size().
+     * @param out The block to decode into. out.size is set to the number of valid tokens.
+     */
+    void decode_block(const PackedTokenList& packed, size_t index, token_block& out);
+
+    /**
+     * @brief Decompresses the whole stream back into a token list.
+     * @param packed The compressed tokens.
+     * @return TokenList The decompressed tokens.
+     */
+    TokenList decompress(const PackedTokenList& packed);
+
+    /**
+     * @brief Calls visitor with each decoded block in order, reusing a single block buffer.
+     * @param packed The compressed tokens.
+     * @param visitor Callable taking a const token_block&.
+     */
+    template<typename Visitor>
+    void for_each_block(const PackedTokenList& packed, Visitor&& visitor)
+    {
+        token_block block;
+        for (size_t i = 0; i < packed.blocks.size(); ++i)
+        {
+            decode_block(packed, i, block);
+            visitor(static_cast<const token_block&>(block));
+        }
+    }
+}
+
+#endif
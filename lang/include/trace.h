@@ -0,0 +1,103 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace nightglow::lang::trace
+{
+    /**
+     * @brief Whether tracing is on for this run. Only consulted when built with NIGHTGLOW_TRACE.
+     */
+    inline std::atomic<bool> active{ false };
+
+    /**
+     * @brief Turns tracing on for the rest of the process.
+     */
+    void enable();
+
+    /**
+     * @brief Checks whether events are being recorded.
+     */
+    inline bool enabled()
+    {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Monotonic time in nanoseconds since the first call.
+     */
+    uint64_t now_ns();
+
+    /**
+     * @brief Names the calling thread's track in the trace, e.g. "lexer".
+     */
+    void set_thread_name(std::string_view name);
+
+    /**
+     * @brief Records a completed event on the calling thread's track. Lock-free; buffers are per thread.
+     * @param name The event name. Must outlive the process (a string literal).
+     * @param begin_ns The start time, from now_ns().
+     * @param duration_ns The duration.
+     * @param detail Optional detail shown in the trace viewer, e.g. a file name.
+     */
+    void record(const char* name, uint64_t begin_ns, uint64_t duration_ns, std::string_view detail = {});
+
+    /**
+     * @brief Writes every recorded event as Chrome/Perfetto trace-event JSON. Call once all threads are done.
+     * @param path The file to write.
+     * @return bool True if the file was written.
+     */
+    bool write_chrome_trace(const std::filesystem::path& path);
+
+    /**
+     * @brief Prints a per-phase summary table (calls, total, mean and share of wall time).
+     * @param out The stream to print to.
+     */
+    void print_time_passes(std::ostream& out);
+
+    /**
+     * @brief Times the enclosing scope and records it as one event.
+     */
+    struct Scope
+    {
+        const char* name;
+        std::string_view detail;
+        bool armed;
+        uint64_t begin;
+
+        explicit Scope(const char* name, const std::string_view detail = {})
+            : name(name), detail(detail), armed(enabled()), begin(armed ? now_ns() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (armed)
+                record(name, begin, now_ns() - begin, detail);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+}
+
+#define NIGHTGLOW_TRACE_CONCAT_IMPL(a, b) a##b
+#define NIGHTGLOW_TRACE_CONCAT(a, b) NIGHTGLOW_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef NIGHTGLOW_TRACE
+#define NIGHTGLOW_TRACE_SCOPE(...) ::nightglow::lang::trace::Scope NIGHTGLOW_TRACE_CONCAT(trace_scope_, __LINE__)(__VA_ARGS__)
+#else
+#define NIGHTGLOW_TRACE_SCOPE(...) static_cast<void>(0)
+#endif
+
+#endif
@@ -0,0 +1,179 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/allocator.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace
+{
+    void* default_allocate(const size_t bytes, const size_t alignment, void*)
+    {
+        return ::operator new(bytes, std::align_val_t(alignment), std::nothrow);
+    }
+
+    void default_deallocate(void* p, const size_t, const size_t alignment, void*)
+    {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    constexpr nightglow::lang::memory::allocator_hooks defaults{ default_allocate, default_deallocate, nullptr };
+    nightglow::lang::memory::allocator_hooks hooks = defaults;
+
+    // containers only allocate when they grow, so relaxed atomics cost nothing measurable
+    std::atomic<uint64_t> allocated_bytes{ 0 };
+    std::atomic<int64_t> live_bytes{ 0 };
+    std::atomic<int64_t> peak_bytes{ 0 };
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> deallocations{ 0 };
+}
+
+void nightglow::lang::memory::set_hooks(const allocator_hooks& replacement)
+{
+    hooks = replacement;
+}
+
+const nightglow::lang::memory::allocator_hooks& nightglow::lang::memory::default_hooks()
+{
+    return defaults;
+}
+
+nightglow::lang::memory::stats nightglow::lang::memory::snapshot()
+{
+    return {
+        allocated_bytes.load(std::memory_order_relaxed),
+        static_cast<uint64_t>(std::max<int64_t>(live_bytes.load(std::memory_order_relaxed), 0)),
+        static_cast<uint64_t>(std::max<int64_t>(peak_bytes.load(std::memory_order_relaxed), 0)),
+        allocations.load(std::memory_order_relaxed),
+        deallocations.load(std::memory_order_relaxed)
+    };
+}
+
+void nightglow::lang::memory::reset()
+{
+    allocated_bytes.store(0, std::memory_order_relaxed);
+    allocations.store(0, std::memory_order_relaxed);
+    deallocations.store(0, std::memory_order_relaxed);
+    peak_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void* nightglow::lang::memory::allocate(const size_t bytes, const size_t alignment)
+{
+    void* p = hooks.allocate(bytes, alignment, hooks.context);
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const int64_t live = live_bytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + static_cast<int64_t>(bytes);
+    int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    return p;
+}
+
+void nightglow::lang::memory::deallocate(void* p, const size_t bytes, const size_t alignment)
+{
+    if (p == nullptr)
+        return;
+    hooks.deallocate(p, bytes, alignment, hooks.context);
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    live_bytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+namespace
+{
+    // chunks start with their header; allocations start after it, maximally aligned
+    constexpr size_t chunk_header = (sizeof(nightglow::lang::memory::Arena::chunk) + alignof(std::max_align_t) - 1)
+        / alignof(std::max_align_t) * alignof(std::max_align_t);
+}
+
+nightglow::lang::memory::Arena::Arena(Arena&& other) noexcept
+    : head(std::exchange(other.head, nullptr)), cursor(std::exchange(other.cursor, nullptr)),
+      limit(std::exchange(other.limit, nullptr)), used(std::exchange(other.used, 0))
+{
+}
+
+nightglow::lang::memory::Arena& nightglow::lang::memory::Arena::operator=(Arena&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        head = std::exchange(other.head, nullptr);
+        cursor = std::exchange(other.cursor, nullptr);
+        limit = std::exchange(other.limit, nullptr);
+        used = std::exchange(other.used, 0);
+    }
+    return *this;
+}
+
+nightglow::lang::memory::Arena::~Arena()
+{
+    release();
+}
+
+void* nightglow::lang::memory::Arena::allocate(const size_t bytes, const size_t alignment)
+{
+    auto address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t{ alignment } - 1);
+    if (cursor == nullptr || address + bytes > reinterpret_cast<uintptr_t>(limit))
+    {
+        size_t size = head == nullptr ? min_chunk_size : std::min(head->size * 2, max_chunk_size);
+        size = std::max(size, chunk_header + bytes + alignment);
+
+        auto* fresh = static_cast<chunk*>(memory::allocate(size, alignof(std::max_align_t)));
+        fresh->next = head;
+        fresh->size = size;
+        head = fresh;
+        cursor = reinterpret_cast<char*>(fresh) + chunk_header;
+        limit = reinterpret_cast<char*>(fresh) + size;
+        address = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(uintptr_t{ alignment } - 1);
+    }
+
+    used += bytes;
+    cursor = reinterpret_cast<char*>(address + bytes);
+    return reinterpret_cast<void*>(address);
+}
+
+bool nightglow::lang::memory::Arena::extend(const void* p, const size_t old_bytes, const size_t new_bytes)
+{
+    if (static_cast<const char*>(p) + old_bytes != cursor || static_cast<size_t>(limit - cursor) < new_bytes - old_bytes)
+        return false;
+    cursor += new_bytes - old_bytes;
+    used += new_bytes - old_bytes;
+    return true;
+}
+
+void nightglow::lang::memory::Arena::reset()
+{
+    if (head == nullptr)
+        return;
+
+    chunk* keep = head;
+    for (chunk* c = head->next; c != nullptr;)
+    {
+        chunk* next = c->next;
+        memory::deallocate(c, c->size, alignof(std::max_align_t));
+        c = next;
+    }
+    keep->next = nullptr;
+    cursor = reinterpret_cast<char*>(keep) + chunk_header;
+    used = 0;
+}
+
+void nightglow::lang::memory::Arena::release()
+{
+    for (chunk* c = head; c != nullptr;)
+    {
+        chunk* next = c->next;
+        memory::deallocate(c, c->size, alignof(std::max_align_t));
+        c = next;
+    }
+    head = nullptr;
+    cursor = nullptr;
+    limit = nullptr;
+    used = 0;
+}
@@ -0,0 +1,120 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/ast.h"
+#include <string>
+#include <vector>
+
+void nightglow::lang::ast::Ast::reserve(const uint32_t nodes)
+{
+    kinds.reserve(arena, nodes);
+    tokens.reserve(arena, nodes);
+    begins.reserve(arena, nodes);
+    ends.reserve(arena, nodes);
+    child_begins.reserve(arena, nodes);
+    child_counts.reserve(arena, nodes);
+    edges.reserve(arena, nodes);
+}
+
+nightglow::lang::ast::node_id nightglow::lang::ast::Ast::add(const node_kind kind, const uint32_t token, const uint32_t begin, const uint32_t end,
+                                                             const std::span<const node_id> children)
+{
+    const node_id id = kinds.size();
+    kinds.push_back(arena, kind);
+    tokens.push_back(arena, token);
+    begins.push_back(arena, begin);
+    ends.push_back(arena, end);
+    child_begins.push_back(arena, edges.size());
+    child_counts.push_back(arena, static_cast<uint32_t>(children.size()));
+    edges.append(arena, children);
+    return id;
+}
+
+nightglow::lang::ast::node_id nightglow::lang::ast::Ast::append(const Ast& other)
+{
+    const node_id offset = size();
+    const uint32_t edge_offset = edges.size();
+    const uint32_t count = other.size();
+    kinds.append(arena, { other.kinds.data, count });
+    tokens.append(arena, { other.tokens.data, count });
+    begins.append(arena, { other.begins.data, count });
+    ends.append(arena, { other.ends.data, count });
+    child_counts.append(arena, { other.child_counts.data, count });
+
+    child_begins.reserve(arena, offset + count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        child_begins.data[offset + i] = other.child_begins[i] + edge_offset;
+    }
+    child_begins.count = offset + count;
+
+    edges.reserve(arena, edge_offset + other.edges.size());
+    for (uint32_t i = 0; i < other.edges.size(); ++i)
+    {
+        const node_id child = other.edges[i];
+        edges.data[edge_offset + i] = child == no_node ? no_node : child + offset;
+    }
+    edges.count = edge_offset + other.edges.size();
+    errors.append(arena, { other.errors.data, other.errors.size() });
+    return offset;
+}
+
+void nightglow::lang::ast::Ast::clear()
+{
+    arena.reset();
+    kinds = {};
+    tokens = {};
+    begins = {};
+    ends = {};
+    child_begins = {};
+    child_counts = {};
+    edges = {};
+    errors = {};
+    root = no_node;
+}
+
+namespace
+{
+    void dump_line(std::ostream& out, const nightglow::lang::ast::Ast& ast, const nightglow::lang::lexer::Lexer& lexer,
+                   const nightglow::lang::ast::node_id id, const size_t depth)
+    {
+        using namespace nightglow::lang;
+        out << std::string(depth * 2, ' ') << ast::node_kind_name(ast.kind(id));
+        if (const uint32_t token = ast.token(id); token < lexer.tokens.size())
+        {
+            out << " '" << lexer::get_token_value(lexer, lexer.tokens[token]) << '\'';
+        }
+        out << " [" << ast.begin(id) << ", " << ast.end(id) << ")\n";
+    }
+}
+
+void nightglow::lang::ast::dump(std::ostream& out, const Ast& ast, const lexer::Lexer& lexer, const node_id id)
+{
+    const node_id start = id == no_node ? ast.root : id;
+    if (start == no_node)
+        return;
+
+    // walk with an explicit stack of unvisited siblings so nesting depth is bounded by memory, not by the native stack
+    dump_line(out, ast, lexer, start, 0);
+    std::vector<std::span<const node_id>> pending{ast.children(start)};
+    while (!pending.empty())
+    {
+        std::span<const node_id>& siblings = pending.back();
+        if (siblings.empty())
+        {
+            pending.pop_back();
+            continue;
+        }
+        const node_id child = siblings.front();
+        siblings = siblings.subspan(1);
+        if (child == no_node)
+        {
+            out << std::string(pending.size() * 2, ' ') << "-\n";
+            continue;
+        }
+        dump_line(out, ast, lexer, child, pending.size());
+        pending.push_back(ast.children(child));
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#ifndef BINARY_FILE_H
+#define BINARY_FILE_H
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+/**
+ * @brief Helpers shared by the writers of the mapped cache files: the token cache and the module files. Internal to
+ * the library, not installed.
+ */
+namespace nightglow::lang::binary_file
+{
+    /**
+     * @brief Rounds an offset up to a multiple of a power of two.
+     */
+    constexpr uint64_t align_up(const uint64_t offset, const uint64_t alignment)
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * @brief Pads the stream up to an offset with zeros, then writes a table there.
+     */
+    template<uint64_t Alignment>
+    void write_table(std::ofstream& out, const void* data, const uint64_t bytes, const uint64_t offset)
+    {
+        static constexpr char padding[Alignment] = {};
+        const auto pos = static_cast<uint64_t>(out.tellp());
+        out.write(padding, static_cast<std::streamsize>(offset - pos));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    }
+
+    /**
+     * @brief Writes a file to a private temporary next to it and renames it into place, so concurrent builds never
+     * observe a partial file. mkstemp picks the temporary, so no two writers share one, in one process or several.
+     * @param path The file to write.
+     * @param fill Writes the contents to the stream it is given; failures are read from the stream afterwards.
+     * @return bool Whether the file was written; on failure the temporary is removed and path is left as it was.
+     */
+    template<typename Fill>
+    bool write_atomically(const std::filesystem::path& path, Fill&& fill)
+    {
+        std::string name = path.string() + ".tmpXXXXXX";
+        const int fd = mkstemp(name.data());
+        if (fd < 0)
+            return false;
+        // mkstemp makes the file private to its owner; the files it replaces were not
+        fchmod(fd, 0644);
+        close(fd);
+
+        std::error_code ec;
+        const std::filesystem::path tmp = name;
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (out)
+                fill(out);
+            // the last buffered bytes are written by close(), so it is checked before the file is renamed into place
+            out.close();
+            if (out.fail())
+            {
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tmp, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+}
+
+#endif
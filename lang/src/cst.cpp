@@ -0,0 +1,80 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/cst.h"
+
+namespace
+{
+    using namespace nightglow::lang;
+
+    /**
+     * @brief All trivia before a token, leading and trailing parts together.
+     */
+    std::span<const trivia_t> before(const TokenList& tokens, const uint32_t token)
+    {
+        const auto [first, last] = std::ranges::equal_range(tokens.trivia, token, {}, &trivia_t::token);
+        return { first, last };
+    }
+
+    /**
+     * @brief Where the trivia before a token stops trailing the previous token: at the first run with a line break.
+     */
+    size_t line_break(const lexer::Lexer& lexer, const std::span<const trivia_t> trivia)
+    {
+        for (size_t i = 0; i < trivia.size(); ++i)
+        {
+            const trivia_t& run = trivia[i];
+            if (run.kind == trivia_kind::WHITESPACE && std::string_view(lexer.src + run.start, run.length).find('\n') != std::string_view::npos)
+                return i;
+        }
+        return trivia.size();
+    }
+}
+
+std::span<const nightglow::lang::trivia_t> nightglow::lang::cst::View::token_leading(const uint32_t token) const
+{
+    const auto trivia = before(lexer.tokens, token);
+    return token == 0 ? trivia : trivia.subspan(line_break(lexer, trivia));
+}
+
+std::span<const nightglow::lang::trivia_t> nightglow::lang::cst::View::token_trailing(const uint32_t token) const
+{
+    if (token + 1 >= lexer.tokens.size())
+        return {};
+    const auto trivia = before(lexer.tokens, token + 1);
+    return trivia.first(line_break(lexer, trivia));
+}
+
+std::span<const nightglow::lang::trivia_t> nightglow::lang::cst::View::leading(const ast::node_id id) const
+{
+    return token_leading(ast.begin(id));
+}
+
+std::span<const nightglow::lang::trivia_t> nightglow::lang::cst::View::trailing(const ast::node_id id) const
+{
+    return ast.end(id) > ast.begin(id) ? token_trailing(ast.end(id) - 1) : std::span<const trivia_t>{};
+}
+
+std::string_view nightglow::lang::cst::View::text(const ast::node_id id) const
+{
+    const TokenList& tokens = lexer.tokens;
+    const uint32_t begin = tokens.starts[ast.begin(id)];
+    if (ast.end(id) == ast.begin(id))
+        return { lexer.src + begin, 0 };
+    const uint32_t last = ast.end(id) - 1;
+    return { lexer.src + begin, tokens.starts[last] + tokens.lengths[last] - begin };
+}
+
+std::string_view nightglow::lang::cst::View::full_text(const ast::node_id id) const
+{
+    const std::string_view inner = text(id);
+    const auto lead = leading(id);
+    const auto trail = trailing(id);
+    const uint32_t begin = lead.empty() ? static_cast<uint32_t>(inner.data() - lexer.src) : lead.front().start;
+    uint32_t end = trail.empty() ? static_cast<uint32_t>(inner.data() - lexer.src + inner.size()) : trail.back().start + trail.back().length;
+    if (ast.end(id) + 1 >= lexer.tokens.size())
+        end = lexer.src_length;
+    return { lexer.src + begin, end - begin };
+}
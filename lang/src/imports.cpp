@@ -0,0 +1,41 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/imports.h"
+#include "../include/trace.h"
+
+nightglow::lang::memory::vector<nightglow::lang::import_decl> nightglow::lang::scan_imports(const std::string_view src)
+{
+    NIGHTGLOW_TRACE_SCOPE("scan_imports");
+    memory::vector<import_decl> imports;
+    auto lexer = lexer::create_lexer(src, src.size());
+
+    const auto next = [&lexer]
+    {
+        const token_t token = lexer::peek_next(lexer);
+        lexer::advance(lexer, token);
+        return token;
+    };
+
+    for (token_t token = next(); token.type == token_i::IMPORT; token = next())
+    {
+        import_decl decl{ {}, token };
+        token_t part = next();
+        while (part.type == token_i::IDENTIFIER)
+        {
+            decl.module += lexer::get_token_value(lexer, part);
+            part = next();
+            if (part.type != token_i::DOT)
+                break;
+            decl.module += '.';
+            part = next();
+        }
+
+        if (part.type != token_i::SEMICOLON || decl.module.empty() || decl.module.back() == '.')
+            break;
+        imports.push_back(std::move(decl));
+    }
+    return imports;
+}
@@ -0,0 +1,737 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/incremental.h"
+#include "../include/trace.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    using namespace nightglow::lang;
+    using ast::node_id;
+    using ast::node_kind;
+    using incremental::Document;
+    using incremental::gap;
+
+    /**
+     * @brief Tokens past the statements parsed again that the parser may peek at before it decides where they end.
+     */
+    constexpr uint32_t parse_lookahead = 4;
+
+    /**
+     * @brief Bytes past the end of a token the lexer may have looked at to end it there.
+     */
+    constexpr uint32_t lex_lookahead = 4;
+
+    /**
+     * @brief Bytes past an edit moved in front of the text gap before lexing; a token reaching further doubles them.
+     */
+    constexpr uint32_t lex_reach = 256;
+
+    /**
+     * @brief Pending shifts kept before they are applied to the tree. Reading a position of a node parsed since the
+     * first of them walks the ones after it.
+     */
+    constexpr size_t max_shifts = 1024;
+
+    /**
+     * @brief The tokens an edit replaced: [begin, old_end) in the old list became [begin, new_end) in the new one.
+     */
+    struct token_window
+    {
+        uint32_t begin;
+        uint32_t old_end;
+        uint32_t new_end;
+    };
+
+    uint32_t text_size(const Document& document)
+    {
+        return static_cast<uint32_t>(document.text.size()) - document.text_gap.size;
+    }
+
+    uint32_t token_count(const Document& document)
+    {
+        return static_cast<uint32_t>(document.lexer.tokens.size()) - document.token_gap.size;
+    }
+
+    uint32_t line_count(const Document& document)
+    {
+        return static_cast<uint32_t>(document.lexer.line_starts.size()) - document.line_gap.size;
+    }
+
+    /**
+     * @brief Where the entry at an index is stored in a column with a gap.
+     */
+    uint32_t slot(const gap& g, const uint32_t i)
+    {
+        return i < g.begin ? i : i + g.size;
+    }
+
+    uint32_t token_start(const Document& document, const uint32_t i)
+    {
+        const uint32_t start = document.lexer.tokens.starts[slot(document.token_gap, i)];
+        return i < document.token_gap.begin ? start : text_size(document) - start;
+    }
+
+    uint32_t token_end(const Document& document, const uint32_t i)
+    {
+        return token_start(document, i) + document.lexer.tokens.lengths[slot(document.token_gap, i)];
+    }
+
+    token_i token_type(const Document& document, const uint32_t i)
+    {
+        return document.lexer.tokens.types[slot(document.token_gap, i)];
+    }
+
+    uint32_t line_start(const Document& document, const uint32_t i)
+    {
+        const uint32_t start = document.lexer.line_starts[slot(document.line_gap, i)];
+        return i < document.line_gap.begin ? start : text_size(document) - start;
+    }
+
+    /**
+     * @brief Moves the entries between a gap and the index it moves to over to the other side of it.
+     */
+    template<typename Column>
+    void move_across(Column& column, const gap& g, const uint32_t to)
+    {
+        constexpr size_t width = sizeof(*column.data());
+        if (to < g.begin)
+            std::memmove(column.data() + to + g.size, column.data() + to, (g.begin - to) * width);
+        else
+            std::memmove(column.data() + g.begin, column.data() + g.begin + g.size, (to - g.begin) * width);
+    }
+
+    /**
+     * @brief Switches the byte offsets that move_across() carried over a gap between absolute, in front of it, and
+     * distances from the end, past it. Either one is the size of the text minus the other.
+     */
+    void flip_offsets(memory::vector<uint32_t>& column, const gap& g, const uint32_t to, const uint32_t size)
+    {
+        const uint32_t low = to < g.begin ? to + g.size : g.begin;
+        const uint32_t high = to < g.begin ? g.begin + g.size : to;
+        for (uint32_t i = low; i < high; ++i)
+        {
+            column[i] = size - column[i];
+        }
+    }
+
+    /**
+     * @brief How many slots to add to a gap so that needed fit. Grows by a share of the column, so that widening,
+     * which moves everything past the gap, is amortized over the edits that fill it.
+     */
+    uint32_t widening(const gap& g, const uint32_t needed, const size_t column_size)
+    {
+        return g.size >= needed ? 0 : needed - g.size + static_cast<uint32_t>(column_size / 16) + 64;
+    }
+
+    void move_text_gap(Document& document, const uint32_t to)
+    {
+        move_across(document.text, document.text_gap, to);
+        document.text_gap.begin = to;
+    }
+
+    /**
+     * @brief Moves the text gap forward so that the text up to a byte offset is contiguous, for the lexer.
+     */
+    void expose_text(Document& document, const uint32_t until)
+    {
+        if (const uint32_t to = std::min(until, text_size(document)); to > document.text_gap.begin)
+            move_text_gap(document, to);
+    }
+
+    void replace_text(Document& document, const incremental::text_edit& edit)
+    {
+        move_text_gap(document, edit.offset);
+        gap& g = document.text_gap;
+        g.size += edit.removed;
+        const auto inserted = static_cast<uint32_t>(edit.inserted.size());
+        if (const uint32_t extra = widening(g, inserted, document.text.size()); extra != 0)
+        {
+            document.text.insert(g.begin + g.size, extra, '\0');
+            g.size += extra;
+        }
+        edit.inserted.copy(document.text.data() + g.begin, inserted);
+        g.begin += inserted;
+        g.size -= inserted;
+    }
+
+    void move_token_gap(Document& document, const uint32_t to)
+    {
+        gap& g = document.token_gap;
+        if (to == g.begin)
+            return;
+        TokenList& tokens = document.lexer.tokens;
+        move_across(tokens.starts, g, to);
+        move_across(tokens.lengths, g, to);
+        move_across(tokens.types, g, to);
+        move_across(tokens.flags, g, to);
+        flip_offsets(tokens.starts, g, to, text_size(document));
+        // the slots the entries left join the gap, which reads as END_OF_FILE so that a parser running into it stops
+        const uint32_t vacated = to < g.begin ? to : std::max(g.begin + g.size, to);
+        const uint32_t vacated_end = to < g.begin ? std::min(g.begin, to + g.size) : to + g.size;
+        std::fill(tokens.types.begin() + vacated, tokens.types.begin() + vacated_end, token_i::END_OF_FILE);
+        g.begin = to;
+    }
+
+    void insert_tokens(Document& document, const memory::vector<token_t>& fresh)
+    {
+        gap& g = document.token_gap;
+        TokenList& tokens = document.lexer.tokens;
+        if (const uint32_t extra = widening(g, static_cast<uint32_t>(fresh.size()), tokens.size()); extra != 0)
+        {
+            const auto at = static_cast<ptrdiff_t>(g.begin + g.size);
+            tokens.starts.insert(tokens.starts.begin() + at, extra, 0);
+            tokens.lengths.insert(tokens.lengths.begin() + at, extra, 0);
+            tokens.types.insert(tokens.types.begin() + at, extra, token_i::END_OF_FILE);
+            tokens.flags.insert(tokens.flags.begin() + at, extra, 0);
+            g.size += extra;
+        }
+        for (const token_t& token : fresh)
+        {
+            tokens.starts[g.begin] = token.start;
+            tokens.lengths[g.begin] = token.length;
+            tokens.types[g.begin] = token.type;
+            tokens.flags[g.begin] = token.flags;
+            ++g.begin;
+            --g.size;
+        }
+    }
+
+    void move_line_gap(Document& document, const uint32_t to)
+    {
+        gap& g = document.line_gap;
+        if (to == g.begin)
+            return;
+        move_across(document.lexer.line_starts, g, to);
+        flip_offsets(document.lexer.line_starts, g, to, text_size(document));
+        g.begin = to;
+    }
+
+    void insert_lines(Document& document, const memory::vector<uint32_t>& fresh)
+    {
+        gap& g = document.line_gap;
+        auto& line_starts = document.lexer.line_starts;
+        if (const uint32_t extra = widening(g, static_cast<uint32_t>(fresh.size()), line_starts.size()); extra != 0)
+        {
+            line_starts.insert(line_starts.begin() + static_cast<ptrdiff_t>(g.begin + g.size), extra, 0);
+            g.size += extra;
+        }
+        std::ranges::copy(fresh, line_starts.begin() + g.begin);
+        g.begin += static_cast<uint32_t>(fresh.size());
+        g.size -= static_cast<uint32_t>(fresh.size());
+    }
+
+    /**
+     * @brief Moves every gap to the end and drops it, so the text and the columns are plain again.
+     */
+    void close_gaps(Document& document)
+    {
+        const uint32_t size = text_size(document);
+        move_text_gap(document, size);
+        document.text.resize(size);
+        document.text_gap = { size, 0 };
+
+        const uint32_t count = token_count(document);
+        move_token_gap(document, count);
+        TokenList& tokens = document.lexer.tokens;
+        tokens.starts.resize(count);
+        tokens.lengths.resize(count);
+        tokens.types.resize(count);
+        tokens.flags.resize(count);
+        document.token_gap = { count, 0 };
+
+        const uint32_t lines = line_count(document);
+        move_line_gap(document, lines);
+        document.lexer.line_starts.resize(lines);
+        document.line_gap = { lines, 0 };
+
+        document.lexer.src = document.text.data();
+        document.lexer.src_length = size;
+    }
+
+    /**
+     * @brief Applies an edit to the text and re-lexes around it, from the end of the token before the first token
+     * reaching the edit, until a new token lines up with an old one past the edit. The old tokens and line starts
+     * from there on sit past the gaps, where their offsets count from the end and so stay as they are.
+     */
+    token_window relex(Document& document, const incremental::text_edit& edit, uint32_t& relexed)
+    {
+        const uint32_t count = token_count(document);
+        uint32_t low = 0;
+        uint32_t high = count - 1;
+        while (low < high)
+        {
+            const uint32_t mid = low + (high - low) / 2;
+            if (token_end(document, mid) < edit.offset)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        // one more token back, in case the edit turns it into a longer one
+        const uint32_t first = low > 0 ? low - 1 : 0;
+        const uint32_t from = first > 0 ? token_end(document, first - 1) : 0;
+
+        // the gaps go in front of everything that may change, while the offsets are still those of the old text
+        move_token_gap(document, first);
+        uint32_t line = 0;
+        for (uint32_t lines = line_count(document); line < lines;)
+        {
+            const uint32_t mid = line + (lines - line) / 2;
+            if (line_start(document, mid) <= from)
+                line = mid + 1;
+            else
+                lines = mid;
+        }
+        move_line_gap(document, line);
+        replace_text(document, edit);
+
+        const uint32_t size = text_size(document);
+        const uint32_t inserted_end = edit.offset + static_cast<uint32_t>(edit.inserted.size());
+        expose_text(document, inserted_end + lex_reach);
+        lexer::LexerState state{ document.text.data(), from, document.text_gap.begin, {} };
+        memory::vector<token_t> fresh;
+        TokenList& tokens = document.lexer.tokens;
+        const auto last = static_cast<uint32_t>(tokens.size() - 1);
+        uint32_t old = document.token_gap.begin + document.token_gap.size;
+        while (true)
+        {
+            const uint32_t at = state.current_pos;
+            const size_t lines = state.line_starts.size();
+            const token_t token = lexer::peek_next(state);
+            // the lexer only sees the text in front of the gap, and a token ending close to it may go on past it
+            if (state.src_length < size && token.start + token.length + lex_lookahead > state.src_length)
+            {
+                expose_text(document, state.src_length + std::max(state.src_length - from, lex_reach));
+                state.src = document.text.data();
+                state.src_length = document.text_gap.begin;
+                state.current_pos = at;
+                state.line_starts.resize(lines);
+                continue;
+            }
+            if (token.start >= inserted_end)
+            {
+                const uint32_t distance = size - token.start;
+                while (old < last && tokens.starts[old] > distance)
+                {
+                    ++old;
+                }
+                if (token.type == token_i::END_OF_FILE
+                    || (tokens.starts[old] == distance && tokens.types[old] == token.type && tokens.lengths[old] == token.length))
+                    break;
+            }
+            if (token.type != token_i::UNKNOWN)
+                fresh.push_back(token);
+            lexer::advance(state, token);
+        }
+
+        // the old line starts up to the token lexing stopped at give way to the new ones
+        const uint32_t resync = tokens.starts[old];
+        gap& lines = document.line_gap;
+        uint32_t kept = lines.begin + lines.size;
+        while (kept < document.lexer.line_starts.size() && document.lexer.line_starts[kept] >= resync)
+        {
+            ++kept;
+        }
+        lines.size = kept - lines.begin;
+        insert_lines(document, state.line_starts);
+
+        // and so do the old tokens in front of it
+        gap& g = document.token_gap;
+        const uint32_t replaced = old - (g.begin + g.size);
+        std::fill(tokens.types.begin() + g.begin + g.size, tokens.types.begin() + old, token_i::END_OF_FILE);
+        g.size += replaced;
+        insert_tokens(document, fresh);
+
+        relexed = static_cast<uint32_t>(fresh.size());
+        return { first, first + replaced, first + static_cast<uint32_t>(fresh.size()) };
+    }
+
+    /**
+     * @brief A token index of a node as of the last edit: the stored one, moved by the shifts pending since the node
+     * was parsed. The nodes older than all of them, nearly all of the tree, look it up in the composed pieces.
+     */
+    uint32_t shifted(const Document& document, const node_id id, uint32_t index)
+    {
+        const auto& shifts = document.shifts;
+        if (shifts.empty())
+            return index;
+        if (id < shifts.front().limit)
+        {
+            const auto piece = std::ranges::upper_bound(document.composed, index, {}, &incremental::shift_piece::from);
+            return static_cast<uint32_t>(index + std::prev(piece)->delta);
+        }
+        for (auto shift = std::ranges::upper_bound(shifts, id, {}, &incremental::pending_shift::limit); shift != shifts.end(); ++shift)
+        {
+            if (index >= shift->from)
+                index = static_cast<uint32_t>(index + shift->delta);
+        }
+        return index;
+    }
+
+    /**
+     * @brief Records a shift, and adds it to the composed pieces: a piece moving its indices by delta past the shift
+     * splits where they reach its from.
+     */
+    void push_shift(Document& document, const incremental::pending_shift& shift)
+    {
+        document.shifts.push_back(shift);
+        memory::vector<incremental::shift_piece>& pieces = document.composed;
+        if (pieces.empty())
+            pieces.push_back({ 0, 0 });
+        memory::vector<incremental::shift_piece> split;
+        split.reserve(pieces.size() + 2);
+        const auto add = [&split](const uint32_t from, const int64_t delta)
+        {
+            if (split.empty() || split.back().delta != delta)
+                split.push_back({ from, delta });
+        };
+        for (size_t i = 0; i < pieces.size(); ++i)
+        {
+            const int64_t begin = pieces[i].from;
+            const int64_t end = i + 1 < pieces.size() ? pieces[i + 1].from : INT64_MAX;
+            const int64_t at = shift.from - pieces[i].delta;
+            if (at <= begin)
+            {
+                add(pieces[i].from, pieces[i].delta + shift.delta);
+            }
+            else if (at >= end)
+            {
+                add(pieces[i].from, pieces[i].delta);
+            }
+            else
+            {
+                add(pieces[i].from, pieces[i].delta);
+                add(static_cast<uint32_t>(at), pieces[i].delta + shift.delta);
+            }
+        }
+        std::swap(pieces, split);
+    }
+
+    /**
+     * @brief Applies the pending shifts to every node in one pass. A shift only applies to the nodes older than it,
+     * so the nodes are rewritten from the newest down while the shifts are composed from the newest down into one
+     * map: sorted breakpoints, each moving the indices from it up to the next one by its offset.
+     */
+    void apply_shifts(Document& document)
+    {
+        ast::Ast& tree = document.ast;
+        memory::vector<std::pair<uint32_t, int64_t>> map{ { 0, 0 } };
+        memory::vector<std::pair<uint32_t, int64_t>> composed;
+        // nodes are created in about source order, so the piece of the index before is tried first
+        size_t piece = 0;
+        const auto apply = [&map, &piece](uint32_t& index)
+        {
+            if (map[piece].first > index || (piece + 1 < map.size() && map[piece + 1].first <= index))
+                piece = std::ranges::upper_bound(map, index, {}, &std::pair<uint32_t, int64_t>::first) - map.begin() - 1;
+            index = static_cast<uint32_t>(index + map[piece].second);
+        };
+        for (size_t k = document.shifts.size(); k-- > 0;)
+        {
+            // with this shift first, an index below from goes through the map as it is, and one at or past it goes
+            // through the map at its shifted place
+            const incremental::pending_shift& shift = document.shifts[k];
+            const int64_t landing = shift.from + shift.delta;
+            int64_t offset = 0;
+            composed.clear();
+            for (const auto& [at, by] : map)
+            {
+                if (at < shift.from)
+                    composed.emplace_back(at, by);
+                if (at <= landing)
+                    offset = by;
+            }
+            composed.emplace_back(shift.from, shift.delta + offset);
+            for (const auto& [at, by] : map)
+            {
+                if (at > landing)
+                    composed.emplace_back(static_cast<uint32_t>(at - shift.delta), by + shift.delta);
+            }
+            std::swap(map, composed);
+            piece = 0;
+
+            for (node_id id = k > 0 ? document.shifts[k - 1].limit : 0; id < shift.limit; ++id)
+            {
+                apply(tree.tokens[id]);
+                apply(tree.begins[id]);
+                apply(tree.ends[id]);
+            }
+        }
+        document.shifts.clear();
+        document.composed.clear();
+    }
+
+    /**
+     * @brief Whether a statement that failed right before this token stops there without skipping it.
+     */
+    bool stops_recovery(const token_i type)
+    {
+        switch (type)
+        {
+            case token_i::FUNCTION:
+            case token_i::CLASS:
+            case token_i::VAR:
+            case token_i::CONST:
+            case token_i::RIGHT_BRACE:
+            case token_i::END_OF_FILE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Counts the nodes of a subtree with an explicit stack, so a deep expression cannot overflow the native
+     * one.
+     */
+    uint32_t subtree_size(const ast::Ast& ast, const node_id id)
+    {
+        uint32_t size = 0;
+        memory::vector<node_id> pending{ id };
+        while (!pending.empty())
+        {
+            const node_id node = pending.back();
+            pending.pop_back();
+            ++size;
+            for (const node_id child : ast.children(node))
+            {
+                if (child != ast::no_node)
+                    pending.push_back(child);
+            }
+        }
+        return size;
+    }
+
+    void reparse_all(Document& document, incremental::edit_stats& stats)
+    {
+        close_gaps(document);
+        document.shifts.clear();
+        document.composed.clear();
+        stats.full = true;
+        stats.reparsed_tokens = static_cast<uint32_t>(document.lexer.tokens.size());
+        stats.replaced_nodes = document.ast.size();
+        document.ast = {};
+        document.garbage = 0;
+        document.ast = parser::parse(document.lexer, document.options);
+    }
+
+    /**
+     * @brief Re-parses the statements a token window touches in the innermost module or block that strictly
+     * contains it, and links them in place of the old ones. Returns false if the new statements do not end where
+     * the old ones did, i.e. the edit reaches past them.
+     */
+    bool reparse(Document& document, const token_window window, incremental::edit_stats& stats)
+    {
+        ast::Ast& tree = document.ast;
+        const auto begin_of = [&](const node_id id) { return shifted(document, id, tree.begin(id)); };
+        const auto end_of = [&](const node_id id) { return shifted(document, id, tree.end(id)); };
+        const auto contains = [&](const node_id child)
+        {
+            return child != ast::no_node && begin_of(child) < window.begin && window.old_end < end_of(child);
+        };
+
+        node_id container = tree.root;
+        for (node_id node = tree.root; node != ast::no_node;)
+        {
+            // children are in source order, so only the last one beginning before the window can contain it. Short
+            // lists are walked instead: the fixed layout of a for loop has no_node children
+            const auto children = tree.children(node);
+            auto inner = children.end();
+            if (children.size() <= 8)
+                inner = std::ranges::find_if(children, contains);
+            else if (const auto after = std::ranges::partition_point(children, [&](const node_id child) { return begin_of(child) < window.begin; });
+                     after != children.begin() && contains(*std::prev(after)))
+                inner = std::prev(after);
+            node = inner != children.end() ? *inner : ast::no_node;
+            if (node != ast::no_node && tree.kind(node) == node_kind::BLOCK)
+                container = node;
+        }
+
+        // statements ending or starting right at the window are taken too: an edit can extend or absorb them.
+        // So are the ERROR nodes a failed statement skipped and empty statements that failed at their first
+        // token, together with the statement before them: they are parsed as one.
+        const auto recovered = [&](const node_id child)
+        {
+            return tree.kind(child) == node_kind::ERROR || begin_of(child) == end_of(child);
+        };
+        const auto children = tree.children(container);
+        const auto siblings = static_cast<uint32_t>(children.size());
+        auto first = static_cast<uint32_t>(std::ranges::partition_point(children, [&](const node_id child) { return end_of(child) < window.begin; })
+                                           - children.begin());
+        auto last = first + static_cast<uint32_t>(std::ranges::partition_point(children.subspan(first), [&](const node_id child)
+        {
+            return begin_of(child) <= window.old_end;
+        }) - children.begin() - first);
+        while (first > 0 && first < last && recovered(children[first]))
+        {
+            --first;
+        }
+        while (last < siblings && first < last && recovered(children[last]))
+        {
+            ++last;
+        }
+        for (uint32_t i = first; i < last; ++i)
+        {
+            // only the leading imports of a module parse as imports
+            if (tree.kind(children[i]) == node_kind::IMPORT)
+                return false;
+        }
+        const uint32_t old_begin = first < last ? std::min(begin_of(children[first]), window.begin) : window.begin;
+        const uint32_t old_end = first < last ? std::max(end_of(children[last - 1]), window.old_end) : window.old_end;
+        const int64_t delta = static_cast<int64_t>(window.new_end) - window.old_end;
+        const auto new_end = static_cast<uint32_t>(old_end + delta);
+        // a block left open reported its missing } at the end of the file, which only a full parse reports again
+        const uint32_t errors = tree.errors.size();
+        if (const uint32_t close = end_of(container); tree.kind(container) == node_kind::BLOCK && errors != 0
+            && tree.errors[errors - 1].token == close && token_type(document, static_cast<uint32_t>(close + delta)) == token_i::END_OF_FILE)
+            return false;
+
+        uint32_t replaced = 0;
+        for (uint32_t i = first; i < last; ++i)
+        {
+            replaced += subtree_size(tree, children[i]);
+        }
+        const uint32_t edges_at = tree.child_begins[container];
+
+        // errors are in token order: keep those before the statements, set aside those after them, and let the
+        // parse append the new ones in between. An error on a boundary token belongs to the statement before it
+        // only if recovery stopped there, which it does on a stop token and never otherwise.
+        const bool own_begin = old_begin == window.begin || !stops_recovery(token_type(document, old_begin));
+        const bool own_end = stops_recovery(token_type(document, new_end));
+        const std::span old_errors(tree.errors.data, errors);
+        const auto errors_before = std::ranges::find_if(old_errors, [&](const ast::syntax_error& error)
+        {
+            return error.token > old_begin || (error.token == old_begin && own_begin);
+        });
+        const auto errors_after = std::find_if(errors_before, old_errors.end(), [&](const ast::syntax_error& error)
+        {
+            return error.token > old_end || (error.token == old_end && !own_end);
+        });
+        memory::vector<ast::syntax_error> later(errors_after, old_errors.end());
+        tree.errors.count = static_cast<uint32_t>(errors_before - old_errors.begin());
+        for (ast::syntax_error& error : later)
+        {
+            error.token = static_cast<uint32_t>(error.token + delta);
+        }
+        // the nodes past the statements move with the tokens, but only when a position is read
+        if (delta != 0)
+            push_shift(document, { tree.size(), window.old_end, delta });
+
+        // the parser reads the token columns directly, so the gap goes past what it may look at
+        move_token_gap(document, std::min(token_count(document), new_end + parse_lookahead));
+        parser::Parser parser;
+        parser.lexer = &document.lexer;
+        parser.tokens = &document.lexer.tokens;
+        parser.options = document.options;
+        const token_i close = tree.kind(container) == node_kind::MODULE ? token_i::END_OF_FILE : token_i::RIGHT_BRACE;
+        parser.ast = std::move(tree);
+        parser.pos = old_begin;
+        parser::parse_statements(parser, close, new_end);
+        tree = std::move(parser.ast);
+        if (parser.pos != new_end)
+            return false;
+        tree.errors.append(tree.arena, later);
+
+        // the new statements take the edges of the old ones when there are as many, and a new range otherwise
+        node_id* edges = tree.edges.data + edges_at;
+        if (parser.scratch.size() == last - first)
+        {
+            std::ranges::copy(parser.scratch, edges + first);
+        }
+        else
+        {
+            memory::vector<node_id> linked(edges, edges + first);
+            linked.insert(linked.end(), parser.scratch.begin(), parser.scratch.end());
+            linked.insert(linked.end(), edges + last, edges + siblings);
+            tree.child_begins[container] = tree.edges.size();
+            tree.child_counts[container] = static_cast<uint32_t>(linked.size());
+            tree.edges.append(tree.arena, linked);
+        }
+
+        document.garbage += replaced;
+        stats.replaced_nodes = replaced;
+        stats.reparsed_tokens = new_end - old_begin;
+        return true;
+    }
+}
+
+nightglow::lang::incremental::Document::Document(Document&& other) noexcept
+    : text(std::move(other.text)), lexer(std::move(other.lexer)), ast(std::move(other.ast)), options(other.options), garbage(other.garbage),
+      text_gap(other.text_gap), token_gap(other.token_gap), line_gap(other.line_gap), shifts(std::move(other.shifts)),
+      composed(std::move(other.composed))
+{
+    lexer.src = text.data();
+}
+
+nightglow::lang::incremental::Document& nightglow::lang::incremental::Document::operator=(Document&& other) noexcept
+{
+    text = std::move(other.text);
+    lexer = std::move(other.lexer);
+    ast = std::move(other.ast);
+    options = other.options;
+    garbage = other.garbage;
+    text_gap = other.text_gap;
+    token_gap = other.token_gap;
+    line_gap = other.line_gap;
+    shifts = std::move(other.shifts);
+    composed = std::move(other.composed);
+    lexer.src = text.data();
+    return *this;
+}
+
+nightglow::lang::incremental::Document nightglow::lang::incremental::open_document(std::string text, const parser::parse_options& options)
+{
+    NIGHTGLOW_TRACE_SCOPE("open_document");
+    Document document;
+    document.text = std::move(text);
+    document.options = options;
+    document.lexer = lexer::create_lexer(document.text, document.text.size());
+    lexer::tokenize(document.lexer);
+    document.ast = parser::parse(document.lexer, options);
+    document.text_gap = { static_cast<uint32_t>(document.text.size()), 0 };
+    document.token_gap = { static_cast<uint32_t>(document.lexer.tokens.size()), 0 };
+    document.line_gap = { static_cast<uint32_t>(document.lexer.line_starts.size()), 0 };
+    return document;
+}
+
+nightglow::lang::incremental::edit_stats nightglow::lang::incremental::apply_edit(Document& document, const text_edit& edit)
+{
+    NIGHTGLOW_TRACE_SCOPE("apply_edit");
+    const uint32_t size = text_size(document);
+    if (edit.offset > size || edit.removed > size - edit.offset)
+    {
+        throw std::runtime_error("Edit out of range");
+    }
+    if (size - edit.removed + edit.inserted.size() > UINT32_MAX)
+    {
+        throw std::runtime_error("Source file too large (>4GiB)");
+    }
+
+    edit_stats stats{};
+    const token_window window = relex(document, edit, stats.relexed_tokens);
+    if (document.ast.root == ast::no_node)
+    {
+        reparse_all(document, stats);
+        return stats;
+    }
+    // whitespace and comments only: the tokens are the same, just at other offsets
+    if (window.begin == window.old_end && window.begin == window.new_end)
+        return stats;
+
+    if (!reparse(document, window, stats) || document.garbage > document.ast.size() / 2)
+        reparse_all(document, stats);
+    else if (document.shifts.size() >= max_shifts)
+        apply_shifts(document);
+    return stats;
+}
+
+void nightglow::lang::incremental::settle(Document& document)
+{
+    NIGHTGLOW_TRACE_SCOPE("settle");
+    close_gaps(document);
+    apply_shifts(document);
+}
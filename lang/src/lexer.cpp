@@ -14,13 +14,16 @@
 #endif
 
 #include "../include/lexer.h"
+#include "../include/trace.h"
+#include <algorithm>
 #include <array>
-#include <iostream>
+#include <cstddef>
 #include <stdexcept>
+#include <string>
 #include <string_view>
-#include <unordered_set>
+#include <type_traits>
 
-const std::array<uint8_t, 256> char_type = []
+constexpr std::array<uint8_t, 256> char_type = []
 {
     std::array<uint8_t, 256> types{};
     for (auto i = 0; i < 256; ++i)
@@ -31,17 +34,24 @@ const std::array<uint8_t, 256> char_type = []
             types[i] = 2;
         else if (i == '*')
             types[i] = 3;
-        else if (std::isalpha(i) || i == '_' || i == '@')
+        else if ((i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z') || i == '_' || i == '@')
             types[i] = 4;
-        else if (std::isdigit(i))
+        else if (i >= '0' && i <= '9')
             types[i] = 5;
+        else if (i == '"')
+            types[i] = 6;
         else
             types[i] = 0;
     }
     return types;
 }();
 
-void nightglow::lang::TokenList::push_back(const token_t &token)
+#ifdef NIGHTGLOW_TRACE
+// skip_whitespace_comment runs once per token, so it is summed per tokenize() call rather than traced per call
+thread_local uint64_t skip_time_ns = 0;
+#endif
+
+void nightglow::lang::BasicTokenList<nightglow::lang::soa_layout>::push_back(const token_t &token)
 {
     starts.emplace_back(token.start);
     lengths.emplace_back(token.length);
@@ -49,7 +59,7 @@ void nightglow::lang::TokenList::push_back(const token_t &token)
     flags.emplace_back(token.flags);
 }
 
-void nightglow::lang::TokenList::reserve(const uint32_t &n = 10000)
+void nightglow::lang::BasicTokenList<nightglow::lang::soa_layout>::reserve(const uint32_t &n)
 {
     starts.reserve(n);
     lengths.reserve(n);
@@ -57,13 +67,223 @@ void nightglow::lang::TokenList::reserve(const uint32_t &n = 10000)
     flags.reserve(n);
 }
 
-nightglow::lang::lexer::Lexer nightglow::lang::lexer::create_lexer(const std::string_view src, const size_t length)
+void nightglow::lang::BasicTokenList<nightglow::lang::soa_layout>::clear()
+{
+    starts.clear();
+    lengths.clear();
+    types.clear();
+    flags.clear();
+    matches.clear();
+    unmatched.clear();
+    trivia.clear();
+}
+
+void nightglow::lang::BasicTokenList<nightglow::lang::aos_layout>::push_back(const token_t &token)
+{
+    records.emplace_back(token);
+}
+
+void nightglow::lang::BasicTokenList<nightglow::lang::aos_layout>::reserve(const uint32_t &n)
+{
+    records.reserve(n);
+}
+
+void nightglow::lang::BasicTokenList<nightglow::lang::aos_layout>::clear()
+{
+    records.clear();
+}
+
+void nightglow::lang::BasicTokenList<nightglow::lang::aosoa_layout>::push_back(const token_t &token)
 {
+    const uint32_t j = count % block_size;
+    if (j == 0)
+    {
+        blocks.emplace_back();
+    }
+    block& b = blocks.back();
+    b.starts[j] = token.start;
+    b.lengths[j] = token.length;
+    b.types[j] = token.type;
+    b.flags[j] = token.flags;
+    ++count;
+}
+
+void nightglow::lang::BasicTokenList<nightglow::lang::aosoa_layout>::reserve(const uint32_t &n)
+{
+    blocks.reserve((n + block_size - 1) / block_size);
+}
+
+void nightglow::lang::BasicTokenList<nightglow::lang::aosoa_layout>::clear()
+{
+    blocks.clear();
+    count = 0;
+}
+
+namespace
+{
+    using namespace nightglow::lang;
+
+    /**
+     * @brief Narrows the length of a lexeme to the 16 bits a token stores.
+     * @param length The lexeme length in bytes.
+     * @param what The kind of lexeme, for the error message.
+     * @return uint16_t The length.
+     * @throws std::runtime_error if the lexeme is longer than 65535 bytes, which would otherwise wrap and resume
+     * lexing inside it.
+     */
+    uint16_t token_length(const std::ptrdiff_t length, const char* what)
+    {
+        if (length > UINT16_MAX) [[unlikely]]
+        {
+            throw std::runtime_error(std::string(what) + " too long (>64KiB)");
+        }
+        return static_cast<uint16_t>(length);
+    }
+
+    /**
+     * @brief Indexes the per-kind stacks of match_brackets by an open bracket's type.
+     */
+    constexpr size_t opener_kind(const token_i type)
+    {
+        return type == token_i::LEFT_PAREN ? 0 : type == token_i::LEFT_BRACE ? 1 : 2;
+    }
+
+    /**
+     * @brief Pairs every bracket in the type column with the innermost open bracket of its kind. Open brackets
+     * skipped over to reach it are left unmatched, and a closer with no opener of its kind is unmatched itself.
+     * Runs over the finished column rather than per token so the lexing loop itself stays untouched. Each kind keeps
+     * its own stack next to the combined one, so a closer finds its opener, or that there is none, without searching,
+     * and every opener is pushed and popped once.
+     */
+    void match_brackets(TokenList& tokens)
+    {
+        const auto count = static_cast<uint32_t>(tokens.size());
+        const token_i* types = tokens.types.data();
+        tokens.matches.assign(count, no_match);
+        uint32_t* matches = tokens.matches.data();
+        memory::vector<uint32_t> open;
+        memory::vector<uint32_t> open_of[3];
+
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            size_t kind;
+            switch (types[index])
+            {
+                case token_i::LEFT_PAREN:
+                case token_i::LEFT_BRACE:
+                case token_i::LEFT_BRACKET:
+                    kind = opener_kind(types[index]);
+                    open.push_back(index);
+                    open_of[kind].push_back(index);
+                    continue;
+                case token_i::RIGHT_PAREN: kind = 0; break;
+                case token_i::RIGHT_BRACE: kind = 1; break;
+                case token_i::RIGHT_BRACKET: kind = 2; break;
+                default: continue;
+            }
+
+            if (open_of[kind].empty())
+            {
+                tokens.unmatched.push_back(index);
+                continue;
+            }
+            // the openers above the partner were opened after it, so each is the top of its own stack
+            const uint32_t partner = open_of[kind].back();
+            while (open.back() != partner)
+            {
+                const uint32_t skipped = open.back();
+                open.pop_back();
+                tokens.unmatched.push_back(skipped);
+                open_of[opener_kind(types[skipped])].pop_back();
+            }
+            open.pop_back();
+            open_of[kind].pop_back();
+            matches[partner] = index;
+            matches[index] = partner;
+        }
+
+        tokens.unmatched.insert(tokens.unmatched.end(), open.begin(), open.end());
+        std::ranges::sort(tokens.unmatched);
+    }
+
+    /**
+     * @brief Measures the run of trivia at pos, which ends at end at the latest.
+     */
+    uint32_t trivia_length(const char* src, const uint32_t pos, const uint32_t end, trivia_kind& kind)
+    {
+        const auto is_space = [src](const uint32_t i) { return src[i] == ' ' || src[i] == '\t' || src[i] == '\n' || src[i] == '\r'; };
+        const auto is_comment = [src, end](const uint32_t i) { return src[i] == '/' && i + 1 < end && (src[i + 1] == '/' || src[i + 1] == '*'); };
+
+        uint32_t i = pos;
+        if (is_space(i))
+        {
+            kind = trivia_kind::WHITESPACE;
+            while (i < end && is_space(i))
+            {
+                ++i;
+            }
+        }
+        else if (is_comment(i) && src[i + 1] == '/')
+        {
+            kind = trivia_kind::LINE_COMMENT;
+            while (i < end && src[i] != '\n')
+            {
+                ++i;
+            }
+        }
+        else if (is_comment(i))
+        {
+            kind = trivia_kind::BLOCK_COMMENT;
+            i += 2;
+            while (i + 1 < end && !(src[i] == '*' && src[i + 1] == '/'))
+            {
+                ++i;
+            }
+            i = std::min(i + 2, end);
+        }
+        else
+        {
+            kind = trivia_kind::SKIPPED;
+            do
+            {
+                ++i;
+            } while (i < end && !is_space(i) && !is_comment(i));
+        }
+        return i - pos;
+    }
+
+    /**
+     * @brief Splits the gaps between tokens into runs of trivia. Like match_brackets, a pass over the finished
+     * columns, so lexing without trivia does not pay for it.
+     */
+    void collect_trivia(const char* src, TokenList& tokens)
+    {
+        const auto count = static_cast<uint32_t>(tokens.size());
+        uint32_t pos = 0;
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            const uint32_t start = tokens.starts[index];
+            while (pos < start)
+            {
+                trivia_kind kind;
+                const uint32_t length = trivia_length(src, pos, start, kind);
+                tokens.trivia.push_back({ index, pos, length, kind });
+                pos += length;
+            }
+            pos = std::max(pos, start + tokens.lengths[index]);
+        }
+    }
+}
+
+template<typename Layout>
+nightglow::lang::lexer::BasicLexer<Layout> nightglow::lang::lexer::create_lexer(const std::string_view src, const size_t length)
+{
+    NIGHTGLOW_TRACE_SCOPE("create_lexer");
     if (length > UINT32_MAX)
     {
         throw std::runtime_error("Source file too large (>4GiB)");
     }
-    Lexer lexer;
+    BasicLexer<Layout> lexer;
     lexer.src = src.data();
     lexer.src_length = static_cast<uint32_t>(length);
     lexer.current_pos = 0;
@@ -71,23 +291,47 @@ nightglow::lang::lexer::Lexer nightglow::lang::lexer::create_lexer(const std::st
     return lexer;
 }
 
-inline void nightglow::lang::lexer::advance(Lexer &lexer)
+template<typename Layout>
+void nightglow::lang::lexer::reset_lexer(BasicLexer<Layout>& lexer, const std::string_view src, const size_t length)
+{
+    if (length > UINT32_MAX)
+    {
+        throw std::runtime_error("Source file too large (>4GiB)");
+    }
+    lexer.src = src.data();
+    lexer.src_length = static_cast<uint32_t>(length);
+    lexer.current_pos = 0;
+    lexer.tokens.clear();
+    lexer.line_starts.clear();
+    lexer.line_starts.push_back(0);
+}
+
+void nightglow::lang::lexer::advance(LexerState &lexer, const token_t& token)
 {
-    lexer.current_pos += lexer.tokens.lengths.back();
+    lexer.current_pos += token.length;
 }
 
-nightglow::lang::token_t nightglow::lang::lexer::peek_next(const lexer::Lexer& lexer)
+nightglow::lang::token_t nightglow::lang::lexer::peek_next(const lexer::LexerState& lexer)
 {
     if (lexer.current_pos >= lexer.src_length)
     {
         return {lexer.current_pos, 0, token_i::END_OF_FILE, 0};
     }
 
-    return next_token(const_cast<lexer::Lexer&>(lexer));
+    return next_token(const_cast<lexer::LexerState&>(lexer));
 }
 
-nightglow::lang::token_t nightglow::lang::lexer::next_token(Lexer& lexer)
+nightglow::lang::token_t nightglow::lang::lexer::next_token(LexerState& lexer)
 {
+    #ifdef NIGHTGLOW_TRACE
+    if (trace::enabled())
+    {
+        const uint64_t begin = trace::now_ns();
+        skip_whitespace_comment(lexer, lexer.src, lexer.current_pos, lexer.src_length);
+        skip_time_ns += trace::now_ns() - begin;
+    }
+    else
+    #endif
     skip_whitespace_comment(lexer, lexer.src, lexer.current_pos, lexer.src_length);
     if (lexer.current_pos >= lexer.src_length)
     {
@@ -98,34 +342,33 @@ nightglow::lang::token_t nightglow::lang::lexer::next_token(Lexer& lexer)
     {
         case 4: return lex_identifier(lexer);
         case 5: return lex_number(lexer);
+        case 6: return lex_string(lexer);
         default:
         {
-            if (lexer.current_pos + 2 < lexer.src_length)
+            for (uint16_t length = 3; length > 0; --length)
             {
-                if (token_map.contains(std::string_view(start, 3)))
+                if (lexer.current_pos + length - 1 < lexer.src_length)
                 {
-                    return {lexer.current_pos, 3, token_map.at(std::string_view(start, 3)), 0};
-                }
-            }
-            if (lexer.current_pos + 1 < lexer.src_length)
-            {
-                if (token_map.contains(std::string_view(start, 2)))
-                {
-                    return {lexer.current_pos, 2, token_map.at(std::string_view(start, 2)), 0};
+                    if (const token_i type = lookup_token(operator_table, std::string_view(start, length)); type != token_i::UNKNOWN)
+                    {
+                        return {lexer.current_pos, length, type, 0};
+                    }
                 }
             }
-            if (token_map.contains(std::string_view(start, 1)))
-            {
-                return {lexer.current_pos, 1, token_map.at(std::string_view(start, 1)), 0};
-            }
             return {lexer.current_pos, 1, token_i::UNKNOWN, 0};
         }
     }
 }
 
-nightglow::lang::TokenList* nightglow::lang::lexer::tokenize(Lexer& lexer)
+template<typename Layout>
+nightglow::lang::BasicTokenList<Layout>* nightglow::lang::lexer::tokenize(BasicLexer<Layout>& lexer)
 {
-    lexer.tokens.reserve(lexer.src_length / 2);
+    #ifdef NIGHTGLOW_TRACE
+    const trace::Scope scope("tokenize");
+    skip_time_ns = 0;
+    #endif
+
+    lexer.tokens.reserve(lexer.src_length / expected_bytes_per_token + 1);
     while (true)
     {
         token_t token = peek_next(lexer);
@@ -138,13 +381,42 @@ nightglow::lang::TokenList* nightglow::lang::lexer::tokenize(Lexer& lexer)
         {
             lexer.tokens.push_back(token);
         }
-        advance(lexer);
+        advance(lexer, token);
     }
 
+    if constexpr (std::is_same_v<Layout, soa_layout>)
+    {
+        if (lexer.match_brackets)
+            match_brackets(lexer.tokens);
+        if (lexer.keep_trivia)
+            collect_trivia(lexer.src, lexer.tokens);
+    }
+
+    #ifdef NIGHTGLOW_TRACE
+    if (scope.armed)
+    {
+        trace::record("skip_whitespace_comment", scope.begin, skip_time_ns);
+    }
+    #endif
     return &lexer.tokens;
 }
 
-void nightglow::lang::lexer::skip_whitespace_comment(Lexer& lexer, const char *src, uint32_t &current_pos, const uint32_t src_length)
+namespace nightglow::lang::lexer
+{
+    template BasicLexer<soa_layout> create_lexer<soa_layout>(std::string_view, size_t);
+    template BasicLexer<aos_layout> create_lexer<aos_layout>(std::string_view, size_t);
+    template BasicLexer<aosoa_layout> create_lexer<aosoa_layout>(std::string_view, size_t);
+
+    template void reset_lexer<soa_layout>(BasicLexer<soa_layout>&, std::string_view, size_t);
+    template void reset_lexer<aos_layout>(BasicLexer<aos_layout>&, std::string_view, size_t);
+    template void reset_lexer<aosoa_layout>(BasicLexer<aosoa_layout>&, std::string_view, size_t);
+
+    template BasicTokenList<soa_layout>* tokenize<soa_layout>(BasicLexer<soa_layout>&);
+    template BasicTokenList<aos_layout>* tokenize<aos_layout>(BasicLexer<aos_layout>&);
+    template BasicTokenList<aosoa_layout>* tokenize<aosoa_layout>(BasicLexer<aosoa_layout>&);
+}
+
+void nightglow::lang::lexer::skip_whitespace_comment(LexerState& lexer, const char *src, uint32_t &current_pos, const uint32_t src_length)
 {
     while (current_pos < src_length)
     {
@@ -264,7 +536,8 @@ void nightglow::lang::lexer::skip_whitespace_comment(Lexer& lexer, const char *s
         }
         #endif
 
-        for (uint32_t i = 0; i < chunk_size; ++i)
+        // a comment skipped inside the chunk can run up to src_length, and nothing past it is part of the source
+        for (uint32_t i = 0; i < chunk_size && current_pos < src_length; ++i)
         {
             const uint8_t type = char_type[static_cast<uint8_t>(src[current_pos])];
 
@@ -317,7 +590,7 @@ void nightglow::lang::lexer::skip_whitespace_comment(Lexer& lexer, const char *s
     }
 }
 
-std::pair<uint32_t, uint32_t> nightglow::lang::lexer::get_line_col(const Lexer& lexer, const token_t& token)
+std::pair<uint32_t, uint32_t> nightglow::lang::lexer::get_line_col(const LexerState& lexer, const token_t& token)
 {
     const auto it = std::ranges::upper_bound(lexer.line_starts, token.start) - 1;
     uint32_t line = std::distance(lexer.line_starts.begin(), it) + 1;
@@ -325,12 +598,12 @@ std::pair<uint32_t, uint32_t> nightglow::lang::lexer::get_line_col(const Lexer&
     return { line, col };
 }
 
-std::string_view nightglow::lang::lexer::get_token_value(const Lexer& lexer, const token_t& token)
+std::string_view nightglow::lang::lexer::get_token_value(const LexerState& lexer, const token_t& token)
 {
     return { &lexer.src[token.start], token.length };
 }
 
-nightglow::lang::token_t nightglow::lang::lexer::lex_identifier(const Lexer &lexer)
+nightglow::lang::token_t nightglow::lang::lexer::lex_identifier(const LexerState &lexer)
 {
     const char* start = lexer.src + lexer.current_pos;
     const char* current = start;
@@ -343,13 +616,13 @@ nightglow::lang::token_t nightglow::lang::lexer::lex_identifier(const Lexer &lex
             ++current;
         }
 
-        const uint16_t length = current - start;
-        if (const std::string_view annotation(start + 1, length - 1); token_map.contains(annotation))
+        const uint16_t length = token_length(current - start, "Annotation");
+        if (const token_i type = lookup_token(annotation_table, std::string_view(start + 1, length - 1)); type != token_i::UNKNOWN)
         {
-            return {lexer.current_pos, static_cast<uint16_t>(current - start), token_map.at(annotation), 0};
+            return {lexer.current_pos, length, type, 0};
         }
 
-        return {lexer.current_pos, static_cast<uint16_t>(current - start), token_i::UNKNOWN, 0};
+        return {lexer.current_pos, length, token_i::UNKNOWN, 0};
     }
 
     while (current < lexer.src + lexer.src_length && (std::isalnum(*current) || *current == '_'))
@@ -357,18 +630,16 @@ nightglow::lang::token_t nightglow::lang::lexer::lex_identifier(const Lexer &lex
         ++current;
     }
 
-    const uint16_t length = current - start;
-    std::string_view identifier(start, length);
-
-    if (token_map.contains(identifier))
+    const uint16_t length = token_length(current - start, "Identifier");
+    if (const token_i type = lookup_token(keyword_table, std::string_view(start, length)); type != token_i::UNKNOWN)
     {
-        return {lexer.current_pos, length, token_map.at(identifier), 0};
+        return {lexer.current_pos, length, type, 0};
     }
 
     return {lexer.current_pos, length, token_i::IDENTIFIER, 0};
 }
 
-nightglow::lang::token_t nightglow::lang::lexer::lex_number(const Lexer &lexer)
+nightglow::lang::token_t nightglow::lang::lexer::lex_number(const LexerState &lexer)
 {
     const char* start = lexer.src + lexer.current_pos;
     const char* current = start;
@@ -412,11 +683,11 @@ nightglow::lang::token_t nightglow::lang::lexer::lex_number(const Lexer &lexer)
         ++current;
     }
 
-    const uint16_t length = current - start;
+    const uint16_t length = token_length(current - start, "Number literal");
     return {lexer.current_pos, length, token_i::NUM_LITERAL, 0};
 }
 
-nightglow::lang::token_t nightglow::lang::lexer::lex_string(const Lexer &lexer)
+nightglow::lang::token_t nightglow::lang::lexer::lex_string(const LexerState &lexer)
 {
     const char* start = lexer.src + lexer.current_pos;
     const char* current = start + 1;
@@ -432,9 +703,9 @@ nightglow::lang::token_t nightglow::lang::lexer::lex_string(const Lexer &lexer)
 
     if (current >= lexer.src + lexer.src_length || *current != '"')
     {
-        return {lexer.current_pos, static_cast<uint16_t>(current - start), token_i::UNKNOWN, 0};
+        return {lexer.current_pos, token_length(current - start, "String literal"), token_i::UNKNOWN, 0};
     }
 
-    const uint16_t length = current - start + 1;
+    const uint16_t length = token_length(current - start + 1, "String literal");
     return {lexer.current_pos, length, token_i::STR_LITERAL, 0};
 }
@@ -0,0 +1,833 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/parser.h"
+#include "../include/trace.h"
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace nightglow::lang;
+    using ast::node_id;
+    using ast::node_kind;
+    using parser::Parser;
+    using parser::expression_frame;
+
+    /**
+     * @brief Records a syntax error at the current token, unless the parser is already recovering from one or
+     * the token already has one, as the end of the file does for every block left open.
+     */
+    void fail(Parser& parser, const std::string_view expected)
+    {
+        const ast::Column<ast::syntax_error>& errors = parser.ast.errors;
+        if (!parser.recovering && (errors.size() == 0 || errors[errors.size() - 1].token != parser.pos))
+            parser.ast.errors.push_back(parser.ast.arena, { parser.pos, expected });
+        parser.recovering = true;
+    }
+
+    /**
+     * @brief A zero-width ERROR node at the current token, standing in for a missing operand or part.
+     */
+    node_id missing(Parser& parser)
+    {
+        return parser.ast.add(node_kind::ERROR, parser.pos, parser.pos, parser.pos);
+    }
+
+    bool accept(Parser& parser, const token_i type)
+    {
+        if (parser.peek() != type)
+            return false;
+        ++parser.pos;
+        return true;
+    }
+
+    /**
+     * @brief Consumes a token of the given type. A missing one is recorded and not consumed, so the token that is
+     * there instead is left for recovery to judge.
+     */
+    uint32_t expect(Parser& parser, const token_i type)
+    {
+        if (parser.peek() != type)
+        {
+            fail(parser, token_name(type));
+            return parser.pos;
+        }
+        return parser.pos++;
+    }
+
+    /**
+     * @brief Adds a node whose children are the scratch entries pushed since base, and pops them.
+     */
+    node_id finish(Parser& parser, const node_kind kind, const uint32_t token, const uint32_t begin, const size_t base)
+    {
+        const node_id id = parser.ast.add(kind, token, begin, parser.pos, { parser.scratch.data() + base, parser.scratch.size() - base });
+        parser.scratch.resize(base);
+        return id;
+    }
+
+    /**
+     * @brief Replaces the values pushed since base with one node that has them as children.
+     */
+    void reduce(Parser& parser, const node_kind kind, const uint32_t token, const uint32_t begin, const uint32_t base)
+    {
+        const node_id id = parser.ast.add(kind, token, begin, parser.pos, { parser.values.data() + base, parser.values.size() - base });
+        parser.values.resize(base);
+        parser.values.push_back(id);
+    }
+
+    /**
+     * @brief Ends recovery after a statement that failed. If the statement did not end on its own ; or }, skips
+     * ahead past the next ; outside parentheses or past the } that closes a block it opened, or up to a } that
+     * closes the enclosing block or the next function, class, var or const, and covers the skipped tokens with an
+     * ERROR node. A brace ends any parentheses left open, so a stray ( cannot swallow the rest of the file.
+     */
+    void synchronize(Parser& parser, const uint32_t begin)
+    {
+        parser.recovering = false;
+        const token_i* types = parser.tokens->types.data();
+        uint32_t braces = 0;
+        uint32_t parens = 0;
+        for (uint32_t i = begin; i < parser.pos; ++i)
+        {
+            braces += types[i] == token_i::LEFT_BRACE;
+            braces -= types[i] == token_i::RIGHT_BRACE && braces > 0;
+            parens += types[i] == token_i::LEFT_PAREN;
+            parens -= types[i] == token_i::RIGHT_PAREN && parens > 0;
+            parens = types[i] == token_i::LEFT_BRACE || types[i] == token_i::RIGHT_BRACE ? 0 : parens;
+        }
+        const token_i last = parser.pos > begin ? types[parser.pos - 1] : token_i::END_OF_FILE;
+        if (braces == 0 && parens == 0 && (last == token_i::SEMICOLON || last == token_i::RIGHT_BRACE))
+            return;
+
+        const uint32_t from = parser.pos;
+        for (auto done = false; !done;)
+        {
+            switch (types[parser.pos])
+            {
+                case token_i::END_OF_FILE:
+                    done = true;
+                    continue;
+                case token_i::RIGHT_BRACE:
+                    if (braces == 0)
+                    {
+                        done = true;
+                        continue;
+                    }
+                    --braces;
+                    parens = 0;
+                    done = braces == 0;
+                    break;
+                case token_i::FUNCTION:
+                case token_i::CLASS:
+                case token_i::VAR:
+                case token_i::CONST:
+                    if (braces == 0)
+                    {
+                        done = true;
+                        continue;
+                    }
+                    break;
+                case token_i::SEMICOLON: done = braces == 0 && parens == 0; break;
+                case token_i::LEFT_BRACE:
+                    ++braces;
+                    parens = 0;
+                    break;
+                case token_i::LEFT_PAREN: ++parens; break;
+                case token_i::RIGHT_PAREN: parens -= parens > 0; break;
+                default: break;
+            }
+            ++parser.pos;
+        }
+
+        // a statement that could not even start is skipped, so the caller always makes progress
+        if (parser.pos == begin && parser.peek() != token_i::END_OF_FILE)
+            ++parser.pos;
+        if (parser.pos > from)
+            parser.scratch.push_back(parser.ast.add(node_kind::ERROR, from, from, parser.pos));
+    }
+
+    node_id parse_primary(Parser& parser)
+    {
+        const uint32_t at = parser.pos;
+        switch (const token_i type = parser.peek())
+        {
+            case token_i::NUM_LITERAL:
+            case token_i::STR_LITERAL:
+            case token_i::TRUE:
+            case token_i::FALSE:
+            case token_i::NIL:
+                ++parser.pos;
+                return parser.ast.add(node_kind::LITERAL, at, at, parser.pos);
+            default:
+                if (type != token_i::IDENTIFIER && !is_type_keyword(type))
+                {
+                    fail(parser, "expression");
+                    return missing(parser);
+                }
+                ++parser.pos;
+                return parser.ast.add(node_kind::IDENTIFIER, at, at, parser.pos);
+        }
+    }
+
+    node_id parse_annotation(Parser& parser)
+    {
+        const uint32_t begin = parser.pos++;
+        const size_t base = parser.scratch.size();
+        if (accept(parser, token_i::LEFT_PAREN) && !accept(parser, token_i::RIGHT_PAREN))
+        {
+            do
+            {
+                parser.scratch.push_back(parser::parse_expression(parser));
+            }
+            while (!parser.recovering && accept(parser, token_i::COMMA));
+            expect(parser, token_i::RIGHT_PAREN);
+        }
+        return finish(parser, node_kind::ANNOTATION, begin, begin, base);
+    }
+
+    node_id parse_import(Parser& parser)
+    {
+        const uint32_t begin = expect(parser, token_i::IMPORT);
+        const uint32_t name = expect(parser, token_i::IDENTIFIER);
+        while (accept(parser, token_i::DOT))
+        {
+            expect(parser, token_i::IDENTIFIER);
+        }
+        expect(parser, token_i::SEMICOLON);
+        return parser.ast.add(node_kind::IMPORT, name, begin, parser.pos);
+    }
+
+    /**
+     * @brief Steps over a braced body and records its range. Jumps straight to the closer when the lexer matched
+     * brackets, and counts braces in the type column otherwise.
+     */
+    node_id skip_body(Parser& parser)
+    {
+        const uint32_t open = parser.pos;
+        if (!parser.tokens->matches.empty())
+        {
+            const uint32_t close = parser.tokens->matches[open];
+            if (close == no_match)
+            {
+                parser.pos = static_cast<uint32_t>(parser.tokens->size() - 1);
+                fail(parser, token_name(token_i::RIGHT_BRACE));
+                return parser.ast.add(node_kind::LAZY_BLOCK, open, open, parser.pos);
+            }
+            parser.pos = close + 1;
+            return parser.ast.add(node_kind::LAZY_BLOCK, open, open, parser.pos);
+        }
+
+        const token_i* types = parser.tokens->types.data();
+        uint32_t depth = 0;
+        do
+        {
+            const token_i type = types[parser.pos];
+            if (type == token_i::END_OF_FILE)
+            {
+                fail(parser, token_name(token_i::RIGHT_BRACE));
+                break;
+            }
+            depth += type == token_i::LEFT_BRACE;
+            depth -= type == token_i::RIGHT_BRACE;
+            ++parser.pos;
+        }
+        while (depth > 0);
+        return parser.ast.add(node_kind::LAZY_BLOCK, open, open, parser.pos);
+    }
+
+    node_id parse_parameter(Parser& parser)
+    {
+        const uint32_t name = expect(parser, token_i::IDENTIFIER);
+        const size_t base = parser.scratch.size();
+        if (accept(parser, token_i::COLON))
+            parser.scratch.push_back(parser::parse_type(parser));
+        if (accept(parser, token_i::EQUAL))
+            parser.scratch.push_back(parser::parse_expression(parser));
+        return finish(parser, node_kind::PARAMETER, name, name, base);
+    }
+
+    // children: annotations, parameters, the return type if any, then the body if any
+    node_id parse_function(Parser& parser, const uint32_t begin, const size_t base)
+    {
+        const uint32_t keyword = expect(parser, token_i::FUNCTION);
+        const uint32_t name = accept(parser, token_i::IDENTIFIER) ? parser.pos - 1 : keyword;
+        expect(parser, token_i::LEFT_PAREN);
+        if (!parser.recovering && !accept(parser, token_i::RIGHT_PAREN))
+        {
+            do
+            {
+                parser.scratch.push_back(parse_parameter(parser));
+            }
+            while (!parser.recovering && accept(parser, token_i::COMMA));
+            expect(parser, token_i::RIGHT_PAREN);
+        }
+        if (accept(parser, token_i::ARROW))
+            parser.scratch.push_back(parser::parse_type(parser));
+        if (parser.recovering)
+            return finish(parser, node_kind::FUNCTION, name, begin, base);
+        if (parser.options.lazy_bodies && parser.peek() == token_i::LEFT_BRACE)
+            parser.scratch.push_back(skip_body(parser));
+        else if (!accept(parser, token_i::SEMICOLON))
+            parser.scratch.push_back(parser::parse_block(parser));
+        return finish(parser, node_kind::FUNCTION, name, begin, base);
+    }
+
+    // children: annotations, the base class type if any, then the members
+    node_id parse_class(Parser& parser, const uint32_t begin, const size_t base)
+    {
+        expect(parser, token_i::CLASS);
+        const uint32_t name = expect(parser, token_i::IDENTIFIER);
+        if (accept(parser, token_i::EXTENDS))
+            parser.scratch.push_back(parser::parse_type(parser));
+        expect(parser, token_i::LEFT_BRACE);
+        if (parser.recovering)
+            return finish(parser, node_kind::CLASS, name, begin, base);
+        parser::parse_statements(parser, token_i::RIGHT_BRACE);
+        expect(parser, token_i::RIGHT_BRACE);
+        return finish(parser, node_kind::CLASS, name, begin, base);
+    }
+
+    // children: annotations, then one VARIABLE per enumerator with its value as child if given
+    node_id parse_enum(Parser& parser, const uint32_t begin, const size_t base)
+    {
+        expect(parser, token_i::ENUM);
+        const uint32_t name = expect(parser, token_i::IDENTIFIER);
+        expect(parser, token_i::LEFT_BRACE);
+        while (!parser.recovering && parser.peek() != token_i::RIGHT_BRACE)
+        {
+            const uint32_t enumerator = expect(parser, token_i::IDENTIFIER);
+            const size_t value_base = parser.scratch.size();
+            if (accept(parser, token_i::EQUAL))
+                parser.scratch.push_back(parser::parse_expression(parser));
+            parser.scratch.push_back(finish(parser, node_kind::VARIABLE, enumerator, enumerator, value_base));
+            if (!accept(parser, token_i::COMMA))
+                break;
+        }
+        expect(parser, token_i::RIGHT_BRACE);
+        return finish(parser, node_kind::ENUM, name, begin, base);
+    }
+
+    // children: annotations, the type if given, then the initializer if given
+    node_id parse_variable(Parser& parser, const uint32_t begin, const size_t base)
+    {
+        ++parser.pos; // var or const
+        const uint32_t name = expect(parser, token_i::IDENTIFIER);
+        if (accept(parser, token_i::COLON))
+            parser.scratch.push_back(parser::parse_type(parser));
+        if (accept(parser, token_i::EQUAL))
+            parser.scratch.push_back(parser::parse_expression(parser));
+        expect(parser, token_i::SEMICOLON);
+        return finish(parser, node_kind::VARIABLE, name, begin, base);
+    }
+
+    node_id parse_expression_statement(Parser& parser)
+    {
+        const uint32_t begin = parser.pos;
+        const size_t base = parser.scratch.size();
+        parser.scratch.push_back(parser::parse_expression(parser));
+        expect(parser, token_i::SEMICOLON);
+        return finish(parser, node_kind::EXPRESSION, begin, begin, base);
+    }
+
+    node_id parse_condition(Parser& parser)
+    {
+        expect(parser, token_i::LEFT_PAREN);
+        const node_id condition = parser::parse_expression(parser);
+        expect(parser, token_i::RIGHT_PAREN);
+        return condition;
+    }
+
+    // children: condition, then, and else if present
+    node_id parse_if(Parser& parser)
+    {
+        const uint32_t begin = expect(parser, token_i::IF);
+        const size_t base = parser.scratch.size();
+        parser.scratch.push_back(parse_condition(parser));
+        parser.scratch.push_back(parser.recovering ? missing(parser) : parser::parse_statement(parser));
+        if (accept(parser, token_i::ELSE))
+            parser.scratch.push_back(parser::parse_statement(parser));
+        return finish(parser, node_kind::IF, begin, begin, base);
+    }
+
+    // children: always init, condition, step and body; missing parts are no_node
+    node_id parse_for(Parser& parser)
+    {
+        const uint32_t begin = expect(parser, token_i::FOR);
+        const size_t base = parser.scratch.size();
+        expect(parser, token_i::LEFT_PAREN);
+
+        if (parser.peek() == token_i::VAR || parser.peek() == token_i::CONST)
+            parser.scratch.push_back(parse_variable(parser, parser.pos, parser.scratch.size()));
+        else if (accept(parser, token_i::SEMICOLON))
+            parser.scratch.push_back(ast::no_node);
+        else
+            parser.scratch.push_back(parse_expression_statement(parser));
+
+        parser.scratch.push_back(parser.peek() == token_i::SEMICOLON ? ast::no_node : parser::parse_expression(parser));
+        expect(parser, token_i::SEMICOLON);
+        parser.scratch.push_back(parser.peek() == token_i::RIGHT_PAREN ? ast::no_node : parser::parse_expression(parser));
+        expect(parser, token_i::RIGHT_PAREN);
+        parser.scratch.push_back(parser.recovering ? missing(parser) : parser::parse_statement(parser));
+        return finish(parser, node_kind::FOR, begin, begin, base);
+    }
+
+    node_id parse_while(Parser& parser)
+    {
+        const uint32_t begin = expect(parser, token_i::WHILE);
+        const size_t base = parser.scratch.size();
+        parser.scratch.push_back(parse_condition(parser));
+        parser.scratch.push_back(parser.recovering ? missing(parser) : parser::parse_statement(parser));
+        return finish(parser, node_kind::WHILE, begin, begin, base);
+    }
+
+    node_id parse_return(Parser& parser)
+    {
+        const uint32_t begin = expect(parser, token_i::RETURN);
+        const size_t base = parser.scratch.size();
+        if (parser.peek() != token_i::SEMICOLON)
+            parser.scratch.push_back(parser::parse_expression(parser));
+        expect(parser, token_i::SEMICOLON);
+        return finish(parser, node_kind::RETURN, begin, begin, base);
+    }
+
+    node_id parse_jump(Parser& parser, const node_kind kind)
+    {
+        const uint32_t begin = parser.pos++;
+        expect(parser, token_i::SEMICOLON);
+        return parser.ast.add(kind, begin, begin, parser.pos);
+    }
+}
+
+namespace
+{
+    /**
+     * @brief A parser with room for the given number of nodes.
+     */
+    Parser make_parser(const lexer::Lexer& lexer, const parser::parse_options& options, const uint32_t nodes)
+    {
+        Parser parser;
+        parser.lexer = &lexer;
+        parser.tokens = &lexer.tokens;
+        parser.options = options;
+        parser.ast.reserve(nodes);
+        parser.scratch.reserve(64);
+        parser.values.reserve(64);
+        parser.frames.reserve(64);
+        return parser;
+    }
+
+    /**
+     * @brief The tree of one run of top-level statements, parsed on its own thread.
+     */
+    struct parsed_range
+    {
+        ast::Ast ast;
+        memory::vector<node_id> statements;
+        std::exception_ptr error;
+        bool overran = false;
+    };
+
+    void parse_range(const lexer::Lexer& lexer, const parser::parse_options& options, const parser::token_range range, parsed_range& out)
+    {
+        NIGHTGLOW_TRACE_SCOPE("parse_range");
+        try
+        {
+            Parser parser = make_parser(lexer, options, range.end - range.begin + 1);
+            parser.pos = range.begin;
+            parser::parse_statements(parser, token_i::END_OF_FILE, range.end);
+            out.statements.assign(parser.scratch.begin(), parser.scratch.end());
+            out.overran = parser.pos != range.end;
+            out.ast = std::move(parser.ast);
+        }
+        catch (...)
+        {
+            out.error = std::current_exception();
+        }
+    }
+
+    /**
+     * @brief Parses the runs of a module on threads and links their trees under one MODULE node. Nodes are
+     * appended in source order, so handles match a serial parse. Returns false when a run did not end on its
+     * boundary or threw, leaving the caller to parse serially.
+     */
+    bool parse_runs(Parser& parser, const lexer::Lexer& lexer, const std::span<const parser::token_range> runs, const uint32_t begin, const size_t base)
+    {
+        std::vector<parsed_range> parsed(runs.size());
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(runs.size() - 1);
+            for (size_t i = 1; i < runs.size(); ++i)
+            {
+                workers.emplace_back([&lexer, &parser, &runs, &parsed, i]
+                {
+                    trace::set_thread_name("parser " + std::to_string(i));
+                    parse_range(lexer, parser.options, runs[i], parsed[i]);
+                });
+            }
+            parse_range(lexer, parser.options, runs[0], parsed[0]);
+        }
+
+        if (std::ranges::any_of(parsed, [](const parsed_range& run) { return run.error || run.overran; }))
+            return false;
+
+        NIGHTGLOW_TRACE_SCOPE("merge");
+        uint32_t nodes = parser.ast.size() + 1;
+        for (const parsed_range& run : parsed)
+        {
+            nodes += run.ast.size();
+        }
+        parser.ast.reserve(nodes);
+        for (const parsed_range& run : parsed)
+        {
+            const node_id offset = parser.ast.append(run.ast);
+            for (const node_id statement : run.statements)
+            {
+                parser.scratch.push_back(statement + offset);
+            }
+        }
+        parser.pos = static_cast<uint32_t>(parser.tokens->size() - 1);
+        parser.ast.root = finish(parser, node_kind::MODULE, begin, begin, base);
+        return true;
+    }
+}
+
+nightglow::lang::parser::Parser nightglow::lang::parser::create_parser(const lexer::Lexer& lexer, const parse_options& options)
+{
+    return make_parser(lexer, options, static_cast<uint32_t>(lexer.tokens.size()) + 1);
+}
+
+nightglow::lang::ast::Ast nightglow::lang::parser::parse(const lexer::Lexer& lexer, const parse_options& options)
+{
+    parse_stats stats{};
+    return parse(lexer, options, stats);
+}
+
+nightglow::lang::ast::Ast nightglow::lang::parser::parse(const lexer::Lexer& lexer, const parse_options& options, parse_stats& stats)
+{
+    NIGHTGLOW_TRACE_SCOPE("parse");
+    stats.runs = 1;
+    const auto count = static_cast<uint32_t>(lexer.tokens.size());
+    const uint32_t threads = options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+    const uint32_t parts = std::min(threads, count / min_tokens_per_thread);
+    if (parts <= 1)
+    {
+        Parser parser = create_parser(lexer, options);
+        parse_module(parser);
+        return std::move(parser.ast);
+    }
+
+    Parser parser = make_parser(lexer, options, 64);
+    const size_t base = parser.scratch.size();
+    while (parser.peek() == token_i::IMPORT)
+    {
+        parser.scratch.push_back(parse_import(parser));
+    }
+    const memory::vector<token_range> runs = split_declarations(lexer.tokens, parser.pos, parts);
+    if (parser.recovering || runs.empty() || !parse_runs(parser, lexer, runs, 0, base))
+    {
+        Parser serial = create_parser(lexer, options);
+        parse_module(serial);
+        return std::move(serial.ast);
+    }
+    stats.runs = static_cast<uint32_t>(runs.size());
+    return std::move(parser.ast);
+}
+
+nightglow::lang::memory::vector<nightglow::lang::parser::token_range> nightglow::lang::parser::split_declarations(const TokenList& tokens,
+    const uint32_t begin, const uint32_t parts)
+{
+    memory::vector<token_range> runs;
+    const auto eof = static_cast<uint32_t>(tokens.size() - 1);
+    if (begin >= eof || parts == 0)
+        return runs;
+
+    const token_i* types = tokens.types.data();
+    const uint32_t* matches = tokens.matches.empty() ? nullptr : tokens.matches.data();
+    const uint32_t target = (eof - begin) / parts;
+    uint32_t start = begin;
+    uint32_t depth = 0;
+    for (uint32_t i = begin; i < eof; ++i)
+    {
+        token_i type = types[i];
+        if (type == token_i::LEFT_PAREN || type == token_i::LEFT_BRACE || type == token_i::LEFT_BRACKET)
+        {
+            if (matches == nullptr || matches[i] == no_match)
+            {
+                ++depth;
+                continue;
+            }
+            i = matches[i];
+            type = types[i];
+        }
+        else if (type == token_i::RIGHT_PAREN || type == token_i::RIGHT_BRACE || type == token_i::RIGHT_BRACKET)
+        {
+            depth -= depth > 0;
+        }
+
+        const bool ends_statement = depth == 0 && (type == token_i::SEMICOLON || type == token_i::RIGHT_BRACE) && types[i + 1] != token_i::ELSE;
+        if (ends_statement && i + 1 - start >= target && runs.size() + 1 < parts)
+        {
+            runs.push_back({ start, i + 1 });
+            start = i + 1;
+        }
+    }
+    if (start < eof)
+        runs.push_back({ start, eof });
+    return runs;
+}
+
+nightglow::lang::ast::node_id nightglow::lang::parser::materialize_body(ast::Ast& ast, const lexer::Lexer& lexer, const ast::node_id function)
+{
+    const auto children = ast.children(function);
+    if (children.empty() || children.back() == ast::no_node)
+        return ast::no_node;
+    const node_id last = children.back();
+    if (ast.kind(last) == node_kind::BLOCK)
+        return last;
+    if (ast.kind(last) != node_kind::LAZY_BLOCK)
+        return ast::no_node;
+
+    NIGHTGLOW_TRACE_SCOPE("materialize_body");
+    Parser parser;
+    parser.lexer = &lexer;
+    parser.tokens = &lexer.tokens;
+    parser.pos = ast.begin(last);
+    parser.ast = std::move(ast);
+
+    const node_id body = parse_block(parser);
+    parser.ast.edges[parser.ast.child_begins[function] + parser.ast.child_counts[function] - 1] = body;
+    ast = std::move(parser.ast);
+    return body;
+}
+
+std::string nightglow::lang::parser::format_error(const lexer::Lexer& lexer, const ast::syntax_error& error)
+{
+    const token_t token = lexer.tokens[error.token];
+    const auto [line, col] = lexer::get_line_col(lexer, token);
+    std::string message = std::to_string(line) + ":" + std::to_string(col) + ": expected " + std::string(error.expected) + ", found "
+        + std::string(token_name(token.type));
+    if (token.type != token_i::END_OF_FILE)
+        message += " '" + std::string(lexer::get_token_value(lexer, token)) + "'";
+    return message;
+}
+
+nightglow::lang::ast::node_id nightglow::lang::parser::parse_module(Parser& parser)
+{
+    const uint32_t begin = parser.pos;
+    const size_t base = parser.scratch.size();
+    while (parser.peek() == token_i::IMPORT)
+    {
+        const uint32_t at = parser.pos;
+        parser.scratch.push_back(parse_import(parser));
+        if (parser.recovering)
+            synchronize(parser, at);
+    }
+    parse_statements(parser, token_i::END_OF_FILE);
+    parser.ast.root = finish(parser, node_kind::MODULE, begin, begin, base);
+    return parser.ast.root;
+}
+
+void nightglow::lang::parser::parse_statements(Parser& parser, const token_i close, const uint32_t end)
+{
+    while (parser.pos < end && parser.peek() != close && parser.peek() != token_i::END_OF_FILE)
+    {
+        const uint32_t begin = parser.pos;
+        parser.scratch.push_back(parse_statement(parser));
+        if (parser.recovering)
+            synchronize(parser, begin);
+    }
+}
+
+nightglow::lang::ast::node_id nightglow::lang::parser::parse_statement(Parser& parser)
+{
+    const uint32_t begin = parser.pos;
+    const size_t base = parser.scratch.size();
+    while (is_annotation(parser.peek()))
+    {
+        parser.scratch.push_back(parse_annotation(parser));
+    }
+    while (is_modifier(parser.peek()))
+    {
+        ++parser.pos;
+    }
+
+    switch (parser.peek())
+    {
+        case token_i::FUNCTION: return parse_function(parser, begin, base);
+        case token_i::CLASS: return parse_class(parser, begin, base);
+        case token_i::ENUM: return parse_enum(parser, begin, base);
+        case token_i::VAR:
+        case token_i::CONST: return parse_variable(parser, begin, base);
+        default: break;
+    }
+    if (parser.pos != begin)
+    {
+        fail(parser, "a declaration after annotations or modifiers");
+        return finish(parser, node_kind::ERROR, begin, begin, base);
+    }
+
+    switch (parser.peek())
+    {
+        case token_i::LEFT_BRACE: return parse_block(parser);
+        case token_i::IF: return parse_if(parser);
+        case token_i::FOR: return parse_for(parser);
+        case token_i::WHILE: return parse_while(parser);
+        case token_i::RETURN: return parse_return(parser);
+        case token_i::BREAK: return parse_jump(parser, node_kind::BREAK);
+        case token_i::CONTINUE: return parse_jump(parser, node_kind::CONTINUE);
+        case token_i::SEMICOLON:
+            ++parser.pos;
+            return parser.ast.add(node_kind::EXPRESSION, begin, begin, parser.pos);
+        default: return parse_expression_statement(parser);
+    }
+}
+
+nightglow::lang::ast::node_id nightglow::lang::parser::parse_block(Parser& parser)
+{
+    const uint32_t begin = expect(parser, token_i::LEFT_BRACE);
+    const size_t base = parser.scratch.size();
+    if (parser.recovering)
+        return finish(parser, node_kind::BLOCK, begin, begin, base);
+    parse_statements(parser, token_i::RIGHT_BRACE);
+    expect(parser, token_i::RIGHT_BRACE);
+    return finish(parser, node_kind::BLOCK, begin, begin, base);
+}
+
+nightglow::lang::ast::node_id nightglow::lang::parser::parse_type(Parser& parser)
+{
+    const uint32_t begin = parser.pos;
+    if (!is_type_keyword(parser.peek()) && parser.peek() != token_i::IDENTIFIER)
+    {
+        fail(parser, "a type");
+        return missing(parser);
+    }
+    ++parser.pos;
+    while (parser.peek() == token_i::DOT && parser.peek(1) == token_i::IDENTIFIER)
+    {
+        parser.pos += 2;
+    }
+    while (parser.peek() == token_i::LEFT_BRACKET && parser.peek(1) == token_i::RIGHT_BRACKET)
+    {
+        parser.pos += 2;
+    }
+    accept(parser, token_i::QUESTION);
+    return parser.ast.add(node_kind::TYPE, begin, begin, parser.pos);
+}
+
+nightglow::lang::ast::node_id nightglow::lang::parser::parse_expression(Parser& parser, const uint8_t min_power)
+{
+    auto& frames = parser.frames;
+    auto& values = parser.values;
+    frames.push_back({ expression_frame::BOTTOM, min_power, parser.pos, parser.pos, static_cast<uint32_t>(values.size()) });
+
+    while (true)
+    {
+        // an operand: prefix operators and open parentheses just push a frame and ask for another operand
+        if (prefix_operators[static_cast<size_t>(parser.peek())])
+        {
+            frames.push_back({ expression_frame::PREFIX, prefix_power, parser.pos, parser.pos, static_cast<uint32_t>(values.size()) });
+            ++parser.pos;
+            continue;
+        }
+        if (parser.peek() == token_i::LEFT_PAREN)
+        {
+            frames.push_back({ expression_frame::GROUP, 0, parser.pos, parser.pos, static_cast<uint32_t>(values.size()) });
+            ++parser.pos;
+            continue;
+        }
+        values.push_back(parse_primary(parser));
+
+        // then either extend the operand with an operator that binds tighter than the innermost frame,
+        // or close that frame and retry with the frame below
+        auto need_operand = false;
+        while (!need_operand)
+        {
+            expression_frame& top = frames.back();
+            const token_i type = parser.peek();
+            if (const infix_rule& rule = infix_rule_of(type); rule.left > top.power)
+            {
+                const uint32_t lhs_begin = parser.ast.begin(values.back());
+                const auto lhs = static_cast<uint32_t>(values.size() - 1);
+                switch (rule.kind)
+                {
+                    case node_kind::MEMBER:
+                    {
+                        ++parser.pos;
+                        const uint32_t name = expect(parser, token_i::IDENTIFIER);
+                        reduce(parser, node_kind::MEMBER, name, lhs_begin, lhs);
+                        break;
+                    }
+                    case node_kind::CALL:
+                        frames.push_back({ expression_frame::CALL, 0, parser.pos++, lhs_begin, lhs });
+                        need_operand = parser.peek() != token_i::RIGHT_PAREN;
+                        break;
+                    case node_kind::INDEX:
+                        frames.push_back({ expression_frame::INDEX, 0, parser.pos++, lhs_begin, lhs });
+                        need_operand = true;
+                        break;
+                    case node_kind::CONDITIONAL:
+                        frames.push_back({ expression_frame::CONDITION_THEN, 0, parser.pos++, lhs_begin, lhs });
+                        need_operand = true;
+                        break;
+                    default:
+                        frames.push_back({ expression_frame::INFIX, rule.right, parser.pos++, lhs_begin, lhs });
+                        need_operand = true;
+                        break;
+                }
+                continue;
+            }
+
+            switch (top.kind)
+            {
+                case expression_frame::BOTTOM:
+                {
+                    const node_id result = values.back();
+                    values.pop_back();
+                    frames.pop_back();
+                    return result;
+                }
+                case expression_frame::PREFIX:
+                    reduce(parser, node_kind::UNARY, top.token, top.begin, top.value_base);
+                    break;
+                case expression_frame::INFIX:
+                    reduce(parser, infix_rule_of(parser.tokens->types[top.token]).kind, top.token, top.begin, top.value_base);
+                    break;
+                case expression_frame::GROUP:
+                    expect(parser, token_i::RIGHT_PAREN);
+                    // the parenthesized expression keeps its own node, its range grows to cover the parentheses
+                    parser.ast.begins[values.back()] = top.begin;
+                    parser.ast.ends[values.back()] = parser.pos;
+                    break;
+                case expression_frame::CALL:
+                    if (accept(parser, token_i::COMMA))
+                    {
+                        need_operand = true;
+                        continue;
+                    }
+                    expect(parser, token_i::RIGHT_PAREN);
+                    reduce(parser, node_kind::CALL, top.token, top.begin, top.value_base);
+                    break;
+                case expression_frame::INDEX:
+                    expect(parser, token_i::RIGHT_BRACKET);
+                    reduce(parser, node_kind::INDEX, top.token, top.begin, top.value_base);
+                    break;
+                case expression_frame::CONDITION_THEN:
+                    expect(parser, token_i::COLON);
+                    top.kind = expression_frame::CONDITION_ELSE;
+                    top.power = infix_rule_of(token_i::QUESTION).right;
+                    need_operand = true;
+                    continue;
+                case expression_frame::CONDITION_ELSE:
+                    reduce(parser, node_kind::CONDITIONAL, top.token, top.begin, top.value_base);
+                    break;
+            }
+            frames.pop_back();
+        }
+    }
+}
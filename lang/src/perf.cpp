@@ -0,0 +1,166 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/perf.h"
+#include <cstdio>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+nightglow::lang::perf::counts& nightglow::lang::perf::counts::operator+=(const counts& other)
+{
+    for (size_t i = 0; i < event_count; ++i)
+    {
+        values[i] += other.values[i];
+        valid[i] = valid[i] || other.valid[i];
+    }
+    return *this;
+}
+
+#ifdef __linux__
+namespace
+{
+    struct event_config
+    {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr event_config configs[nightglow::lang::perf::event_count] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16 },
+    };
+}
+
+nightglow::lang::perf::Counters::Counters()
+{
+    for (size_t i = 0; i < event_count; ++i)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = configs[i].type;
+        attr.config = configs[i].config;
+        attr.disabled = 1;
+        // user space only, so this works with the default perf_event_paranoid of 2
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds[i] < 0 && error.empty())
+        {
+            error = std::string(event_names[i]) + ": " + std::strerror(errno);
+        }
+    }
+}
+
+nightglow::lang::perf::Counters::~Counters()
+{
+    for (const int fd : fds)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+void nightglow::lang::perf::Counters::start()
+{
+    for (const int fd : fds)
+    {
+        if (fd < 0)
+            continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+nightglow::lang::perf::counts nightglow::lang::perf::Counters::stop()
+{
+    for (const int fd : fds)
+    {
+        if (fd >= 0)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    counts result;
+    for (size_t i = 0; i < event_count; ++i)
+    {
+        uint64_t values[3]{}; // value, time enabled, time running
+        if (fds[i] < 0 || read(fds[i], values, sizeof(values)) != sizeof(values) || values[2] == 0)
+            continue;
+        result.values[i] = values[2] < values[1]
+            ? static_cast<uint64_t>(static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]))
+            : values[0];
+        result.valid[i] = true;
+    }
+    return result;
+}
+#else
+nightglow::lang::perf::Counters::Counters() : error("perf_event is only available on Linux")
+{
+}
+
+nightglow::lang::perf::Counters::~Counters() = default;
+
+void nightglow::lang::perf::Counters::start()
+{
+}
+
+nightglow::lang::perf::counts nightglow::lang::perf::Counters::stop()
+{
+    return {};
+}
+#endif
+
+bool nightglow::lang::perf::Counters::available() const
+{
+    for (const int fd : fds)
+    {
+        if (fd >= 0)
+            return true;
+    }
+    return false;
+}
+
+void nightglow::lang::perf::print_report(std::ostream& out, const std::string_view phase, const counts& c, const uint64_t bytes, const uint64_t tokens)
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "perf: %.*s (%llu bytes, %llu tokens)\n", static_cast<int>(phase.size()), phase.data(),
+                  static_cast<unsigned long long>(bytes), static_cast<unsigned long long>(tokens));
+    out << line;
+
+    for (size_t i = 0; i < event_count; ++i)
+    {
+        if (!c.valid[i])
+        {
+            std::snprintf(line, sizeof(line), "  %-14s %16s\n", event_names[i].data(), "n/a");
+            out << line;
+            continue;
+        }
+
+        const auto value = static_cast<double>(c.values[i]);
+        char per_token[24] = "-";
+        if (tokens > 0)
+            std::snprintf(per_token, sizeof(per_token), "%.3f/token", value / static_cast<double>(tokens));
+        std::snprintf(line, sizeof(line), "  %-14s %16llu %14.3f/byte %16s\n", event_names[i].data(),
+                      static_cast<unsigned long long>(c.values[i]), bytes > 0 ? value / static_cast<double>(bytes) : 0.0, per_token);
+        out << line;
+    }
+
+    if (c.has(event::CYCLES) && c.has(event::INSTRUCTIONS) && c[event::CYCLES] > 0)
+    {
+        std::snprintf(line, sizeof(line), "  IPC %.2f\n", static_cast<double>(c[event::INSTRUCTIONS]) / static_cast<double>(c[event::CYCLES]));
+        out << line;
+    }
+}
@@ -0,0 +1,85 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/pipeline.h"
+#include "../include/trace.h"
+
+nightglow::lang::pipeline::token_batch& nightglow::lang::pipeline::TokenRing::acquire()
+{
+    const uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    while (h - t == ring_capacity)
+    {
+        tail.wait(t, std::memory_order_acquire);
+        t = tail.load(std::memory_order_acquire);
+    }
+    return slots[h % ring_capacity];
+}
+
+void nightglow::lang::pipeline::TokenRing::publish()
+{
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    head.notify_one();
+}
+
+const nightglow::lang::pipeline::token_batch& nightglow::lang::pipeline::TokenRing::front()
+{
+    const uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    while (h == t)
+    {
+        head.wait(h, std::memory_order_acquire);
+        h = head.load(std::memory_order_acquire);
+    }
+    return slots[t % ring_capacity];
+}
+
+void nightglow::lang::pipeline::TokenRing::release()
+{
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    tail.notify_one();
+}
+
+void nightglow::lang::pipeline::produce(lexer::LexerState& lexer, TokenRing& ring, std::exception_ptr& error)
+{
+    trace::set_thread_name("lexer");
+    NIGHTGLOW_TRACE_SCOPE("tokenize (pipelined)");
+    try
+    {
+        bool done = false;
+        while (!done)
+        {
+            token_batch& batch = ring.acquire();
+            batch.size = 0;
+            while (batch.size < batch_size)
+            {
+                const token_t token = lexer::peek_next(lexer);
+                if (token.type == token_i::END_OF_FILE)
+                {
+                    batch.tokens[batch.size++] = token;
+                    done = true;
+                    break;
+                }
+                if (token.type != token_i::UNKNOWN)
+                {
+                    batch.tokens[batch.size++] = token;
+                }
+                lexer::advance(lexer, token);
+            }
+
+            done = done || ring.stop.load(std::memory_order_relaxed);
+            batch.last = done;
+            ring.publish();
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+        token_batch& batch = ring.acquire();
+        batch.size = 0;
+        batch.last = true;
+        ring.publish();
+    }
+}
@@ -0,0 +1,736 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/precompiled.h"
+#include "../include/token_cache.h"
+#include "../include/trace.h"
+#include "binary_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace
+{
+    using namespace nightglow::lang;
+    using ast::node_id;
+    using ast::node_kind;
+    using precompiled::decl_record;
+    using precompiled::param_record;
+    using precompiled::string_ref;
+
+    constexpr char module_magic[8] = { 'N', 'G', 'M', 'O', 'D', 0, 0, 0 };
+    constexpr uint32_t module_endian_tag = 0x01020304;
+
+    static_assert(std::is_trivially_copyable_v<decl_record> && std::is_trivially_copyable_v<param_record>);
+
+    uint64_t align_up(const uint64_t offset)
+    {
+        return binary_file::align_up(offset, precompiled::table_alignment);
+    }
+
+    bool table_in_bounds(const uint64_t offset, const uint64_t count, const uint64_t element_size, const size_t file_size)
+    {
+        return offset % alignof(uint32_t) == 0 && offset <= file_size && count * element_size <= file_size - offset;
+    }
+
+    void write_table(std::ofstream& out, const void* data, const uint64_t bytes, const uint64_t offset)
+    {
+        binary_file::write_table<precompiled::table_alignment>(out, data, bytes, offset);
+    }
+
+    std::string_view token_text(const lexer::Lexer& lexer, const uint32_t token)
+    {
+        return lexer::get_token_value(lexer, lexer.tokens[token]);
+    }
+
+    // types and import names are spelled without whitespace, e.g. "core.Vec[]?"
+    string_ref spell(const lexer::Lexer& lexer, precompiled::Interface& out, const uint32_t begin, const uint32_t end)
+    {
+        if (end == begin + 1)
+            return out.intern(token_text(lexer, begin));
+        std::string spelled;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            spelled += token_text(lexer, i);
+        }
+        return out.intern(spelled);
+    }
+
+    /**
+     * @brief Maps a modifier keyword to its flag. CONST counts as one, since it sits in the same place.
+     */
+    uint16_t modifier_flag(const token_i type)
+    {
+        switch (type)
+        {
+            case token_i::PUBLIC: return precompiled::PUBLIC;
+            case token_i::PROTECTED: return precompiled::PROTECTED;
+            case token_i::FINAL: return precompiled::FINAL;
+            case token_i::INLINE: return precompiled::INLINE;
+            case token_i::ASYNC: return precompiled::ASYNC;
+            case token_i::CONST: return precompiled::CONSTANT;
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief Walks the declarations of a tree into an interface.
+     */
+    struct extractor
+    {
+        const lexer::Lexer& lexer;
+        const ast::Ast& ast;
+        precompiled::Interface& out;
+
+        std::string_view text(const uint32_t token) const
+        {
+            return token_text(lexer, token);
+        }
+
+        string_ref type_of(const node_id type)
+        {
+            return spell(lexer, out, ast.begin(type), ast.end(type));
+        }
+
+        void add(const node_id id, const uint32_t parent)
+        {
+            const node_kind kind = ast.kind(id);
+            if (kind != node_kind::FUNCTION && kind != node_kind::CLASS && kind != node_kind::ENUM && kind != node_kind::VARIABLE)
+                return;
+
+            // modifiers sit between the annotations and the keyword, and are not nodes
+            uint16_t flags = 0;
+            for (uint32_t i = ast.begin(id); i < ast.token(id); ++i)
+            {
+                if (lexer.tokens.types[i] == token_i::PRIVATE)
+                    return;
+                flags |= modifier_flag(lexer.tokens.types[i]);
+            }
+
+            const auto index = static_cast<uint32_t>(out.decls.size());
+            decl_record record{};
+            record.name = out.intern(text(ast.token(id)));
+            record.parent = parent;
+            record.kind = kind;
+            record.line = lexer::get_line_col(lexer, lexer.tokens[ast.token(id)]).first;
+            record.first_param = static_cast<uint32_t>(out.params.size());
+            record.first_annotation = static_cast<uint32_t>(out.annotations.size());
+
+            const auto children = ast.children(id);
+            memory::vector<node_id> members;
+            for (const node_id child : children)
+            {
+                if (child == ast::no_node)
+                    continue;
+                switch (ast.kind(child))
+                {
+                    case node_kind::ANNOTATION:
+                        out.annotations.push_back(out.intern(text(ast.token(child))));
+                        break;
+                    case node_kind::PARAMETER:
+                    {
+                        const auto parts = ast.children(child);
+                        const bool typed = !parts.empty() && ast.kind(parts[0]) == node_kind::TYPE;
+                        out.params.push_back({ out.intern(text(ast.token(child))), typed ? type_of(parts[0]) : string_ref{},
+                                               static_cast<uint32_t>(parts.size() > (typed ? 1u : 0u)) });
+                        break;
+                    }
+                    case node_kind::TYPE:
+                        record.type = type_of(child);
+                        break;
+                    case node_kind::BLOCK:
+                    case node_kind::LAZY_BLOCK:
+                        flags |= kind == node_kind::FUNCTION ? precompiled::HAS_BODY : 0;
+                        break;
+                    default:
+                        if (kind == node_kind::CLASS || kind == node_kind::ENUM)
+                            members.push_back(child);
+                        break;
+                }
+            }
+            record.param_count = static_cast<uint32_t>(out.params.size()) - record.first_param;
+            record.annotation_count = static_cast<uint32_t>(out.annotations.size()) - record.first_annotation;
+            record.flags = flags;
+            out.decls.push_back(record);
+
+            for (const node_id member : members)
+            {
+                add(member, index);
+            }
+        }
+    };
+
+    /**
+     * @brief Skims the declarations of a token list into an interface in the same order as extractor, following
+     * the grammar of parser::parse_statement only as far as declarations go and stepping over everything else as
+     * bracket groups. Strings are interned in the same order too, so a clean module gives the same tables.
+     */
+    struct skimmer
+    {
+        const lexer::Lexer& lexer;
+        const token_i* types;
+        uint32_t eof;
+        precompiled::Interface& out;
+        uint32_t pos{};
+        uint32_t line{}; // declarations come in source order, so their lines are found by walking forward
+
+        [[nodiscard]] uint32_t line_of(const uint32_t token)
+        {
+            const uint32_t start = lexer.tokens.starts[token];
+            const auto& line_starts = lexer.line_starts;
+            while (line + 1 < line_starts.size() && line_starts[line + 1] <= start)
+            {
+                ++line;
+            }
+            return line + 1;
+        }
+
+        [[nodiscard]] token_i peek(const uint32_t ahead = 0) const
+        {
+            return types[std::min(pos + ahead, eof)];
+        }
+
+        bool accept(const token_i type)
+        {
+            if (peek() != type)
+                return false;
+            ++pos;
+            return true;
+        }
+
+        static bool is_open(const token_i type)
+        {
+            return type == token_i::LEFT_PAREN || type == token_i::LEFT_BRACE || type == token_i::LEFT_BRACKET;
+        }
+
+        static bool is_close(const token_i type)
+        {
+            return type == token_i::RIGHT_PAREN || type == token_i::RIGHT_BRACE || type == token_i::RIGHT_BRACKET;
+        }
+
+        /**
+         * @brief Steps over the bracket group that opens at pos. Jumps straight past the closer when the lexer
+         * matched brackets, and counts brackets otherwise; an unclosed group runs to the end of the file.
+         */
+        void skip_group()
+        {
+            if (const auto& matches = lexer.tokens.matches; !matches.empty())
+            {
+                const uint32_t close = matches[pos];
+                pos = close == no_match ? eof : close + 1;
+                return;
+            }
+            uint32_t depth = 0;
+            do
+            {
+                depth += is_open(types[pos]);
+                depth -= is_close(types[pos]);
+                ++pos;
+            }
+            while (depth > 0 && pos < eof);
+        }
+
+        /**
+         * @brief Steps over an expression, up to one of two tokens or a closer that is not its own.
+         */
+        void skip_until(const token_i stop, const token_i other)
+        {
+            while (pos < eof && peek() != stop && peek() != other && !is_close(peek()))
+            {
+                if (is_open(peek()))
+                    skip_group();
+                else
+                    ++pos;
+            }
+        }
+
+        /**
+         * @brief Steps over a statement that is not a declaration: up to its ; or its last braced group. Always
+         * makes progress, so a stray closer is stepped over on its own.
+         */
+        void skip_statement()
+        {
+            const uint32_t begin = pos;
+            while (pos < eof)
+            {
+                const token_i type = peek();
+                if (type == token_i::SEMICOLON)
+                {
+                    ++pos;
+                    return;
+                }
+                if (type == token_i::LEFT_BRACE)
+                {
+                    skip_group();
+                    if (peek() != token_i::ELSE)
+                        return;
+                    continue;
+                }
+                if (is_open(type))
+                {
+                    skip_group();
+                    continue;
+                }
+                if (is_close(type))
+                {
+                    pos += pos == begin;
+                    return;
+                }
+                ++pos;
+            }
+        }
+
+        // the tokens parser::parse_type accepts
+        string_ref type()
+        {
+            const uint32_t begin = pos;
+            if (!is_type_keyword(peek()) && peek() != token_i::IDENTIFIER)
+                return {};
+            ++pos;
+            while (peek() == token_i::DOT && peek(1) == token_i::IDENTIFIER)
+            {
+                pos += 2;
+            }
+            while (peek() == token_i::LEFT_BRACKET && peek(1) == token_i::RIGHT_BRACKET)
+            {
+                pos += 2;
+            }
+            accept(token_i::QUESTION);
+            return spell(lexer, out, begin, pos);
+        }
+
+        void import()
+        {
+            ++pos;
+            const uint32_t begin = pos;
+            if (accept(token_i::IDENTIFIER))
+            {
+                while (peek() == token_i::DOT && peek(1) == token_i::IDENTIFIER)
+                {
+                    pos += 2;
+                }
+            }
+            const uint32_t end = pos;
+            if (end > begin && accept(token_i::SEMICOLON))
+                out.imports.push_back(spell(lexer, out, begin, end));
+            else
+                skip_statement();
+        }
+
+        /**
+         * @brief Starts the record of a declaration and adds its annotations, which are the tokens from
+         * annotations up to the modifiers.
+         */
+        decl_record open(const node_kind kind, const uint32_t name, const uint32_t parent, const uint32_t annotations, const uint32_t modifiers)
+        {
+            decl_record record{};
+            record.name = out.intern(token_text(lexer, name));
+            record.parent = parent;
+            record.kind = kind;
+            record.line = line_of(name);
+            record.first_param = static_cast<uint32_t>(out.params.size());
+            record.first_annotation = static_cast<uint32_t>(out.annotations.size());
+            const uint32_t resume = pos;
+            pos = annotations;
+            while (pos < modifiers)
+            {
+                out.annotations.push_back(out.intern(token_text(lexer, pos++)));
+                if (peek() == token_i::LEFT_PAREN)
+                    skip_group();
+            }
+            pos = resume;
+            return record;
+        }
+
+        uint32_t close(decl_record& record, const uint16_t flags)
+        {
+            record.param_count = static_cast<uint32_t>(out.params.size()) - record.first_param;
+            record.annotation_count = static_cast<uint32_t>(out.annotations.size()) - record.first_annotation;
+            record.flags = flags;
+            out.decls.push_back(record);
+            return static_cast<uint32_t>(out.decls.size() - 1);
+        }
+
+        uint32_t name_after(const uint32_t keyword)
+        {
+            return accept(token_i::IDENTIFIER) ? pos - 1 : keyword;
+        }
+
+        void skim_function(const uint32_t parent, const uint32_t annotations, const uint32_t modifiers, uint16_t flags)
+        {
+            const uint32_t keyword = pos++;
+            decl_record record = open(node_kind::FUNCTION, name_after(keyword), parent, annotations, modifiers);
+            if (accept(token_i::LEFT_PAREN) && !accept(token_i::RIGHT_PAREN))
+            {
+                while (peek() == token_i::IDENTIFIER)
+                {
+                    const string_ref name = out.intern(token_text(lexer, pos++));
+                    const string_ref type = accept(token_i::COLON) ? this->type() : string_ref{};
+                    const bool has_default = accept(token_i::EQUAL);
+                    if (has_default)
+                        skip_until(token_i::COMMA, token_i::RIGHT_PAREN);
+                    out.params.push_back({ name, type, has_default });
+                    if (!accept(token_i::COMMA))
+                        break;
+                }
+                accept(token_i::RIGHT_PAREN);
+            }
+            if (accept(token_i::ARROW))
+                record.type = type();
+            if (peek() == token_i::LEFT_BRACE)
+            {
+                skip_group();
+                flags |= precompiled::HAS_BODY;
+            }
+            else
+            {
+                accept(token_i::SEMICOLON);
+            }
+            close(record, flags);
+        }
+
+        void skim_class(const uint32_t parent, const uint32_t annotations, const uint32_t modifiers, const uint16_t flags)
+        {
+            const uint32_t keyword = pos++;
+            decl_record record = open(node_kind::CLASS, name_after(keyword), parent, annotations, modifiers);
+            if (accept(token_i::EXTENDS))
+                record.type = type();
+            const bool body = accept(token_i::LEFT_BRACE);
+            const uint32_t index = close(record, flags);
+            while (body && pos < eof && peek() != token_i::RIGHT_BRACE)
+            {
+                statement(index);
+            }
+            accept(token_i::RIGHT_BRACE);
+        }
+
+        void skim_enum(const uint32_t parent, const uint32_t annotations, const uint32_t modifiers, const uint16_t flags)
+        {
+            const uint32_t keyword = pos++;
+            decl_record record = open(node_kind::ENUM, name_after(keyword), parent, annotations, modifiers);
+            const bool body = accept(token_i::LEFT_BRACE);
+            const uint32_t index = close(record, flags);
+            while (body && peek() == token_i::IDENTIFIER)
+            {
+                decl_record enumerator = open(node_kind::VARIABLE, pos, index, pos, pos);
+                ++pos;
+                if (accept(token_i::EQUAL))
+                    skip_until(token_i::COMMA, token_i::RIGHT_BRACE);
+                close(enumerator, 0);
+                if (!accept(token_i::COMMA))
+                    break;
+            }
+            accept(token_i::RIGHT_BRACE);
+        }
+
+        void skim_variable(const uint32_t parent, const uint32_t annotations, const uint32_t modifiers, const uint16_t flags)
+        {
+            const uint32_t keyword = pos++;
+            decl_record record = open(node_kind::VARIABLE, name_after(keyword), parent, annotations, modifiers);
+            if (accept(token_i::COLON))
+                record.type = type();
+            if (accept(token_i::EQUAL))
+                skip_until(token_i::SEMICOLON, token_i::SEMICOLON);
+            accept(token_i::SEMICOLON);
+            close(record, flags | modifier_flag(types[keyword]));
+        }
+
+        void statement(const uint32_t parent)
+        {
+            const uint32_t begin = pos;
+            while (is_annotation(peek()))
+            {
+                ++pos;
+                if (peek() == token_i::LEFT_PAREN)
+                    skip_group();
+            }
+            const uint32_t modifiers = pos;
+            uint16_t flags = 0;
+            auto hidden = false;
+            while (is_modifier(peek()))
+            {
+                hidden = hidden || peek() == token_i::PRIVATE;
+                flags |= modifier_flag(peek());
+                ++pos;
+            }
+
+            const token_i keyword = peek();
+            const bool declaration = keyword == token_i::FUNCTION || keyword == token_i::CLASS || keyword == token_i::ENUM
+                || keyword == token_i::VAR || keyword == token_i::CONST;
+            if (hidden || !declaration)
+            {
+                // annotations and modifiers without a declaration are a syntax error; they are dropped on their own
+                if (pos == begin || declaration)
+                    skip_statement();
+                return;
+            }
+            switch (keyword)
+            {
+                case token_i::FUNCTION: skim_function(parent, begin, modifiers, flags); break;
+                case token_i::CLASS: skim_class(parent, begin, modifiers, flags); break;
+                case token_i::ENUM: skim_enum(parent, begin, modifiers, flags); break;
+                default: skim_variable(parent, begin, modifiers, flags); break;
+            }
+        }
+    };
+}
+
+nightglow::lang::precompiled::string_ref nightglow::lang::precompiled::Interface::intern(const std::string_view text)
+{
+    // keep the table at most half full; growing rehashes the pooled strings
+    if (2 * (interned + 1) > slots.size())
+    {
+        memory::vector<string_ref> grown(std::max<size_t>(64, 2 * slots.size()), string_ref{ no_decl, 0 });
+        for (const string_ref ref : slots)
+        {
+            if (ref.offset == no_decl)
+                continue;
+            size_t slot = std::hash<std::string_view>{}(string(ref)) & (grown.size() - 1);
+            while (grown[slot].offset != no_decl)
+            {
+                slot = (slot + 1) & (grown.size() - 1);
+            }
+            grown[slot] = ref;
+        }
+        slots = std::move(grown);
+    }
+
+    size_t slot = std::hash<std::string_view>{}(text) & (slots.size() - 1);
+    for (; slots[slot].offset != no_decl; slot = (slot + 1) & (slots.size() - 1))
+    {
+        if (string(slots[slot]) == text)
+            return slots[slot];
+    }
+    slots[slot] = { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size()) };
+    strings += text;
+    ++interned;
+    return slots[slot];
+}
+
+nightglow::lang::precompiled::MappedModule::MappedModule(MappedModule&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+nightglow::lang::precompiled::MappedModule& nightglow::lang::precompiled::MappedModule::operator=(MappedModule&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (base)
+        {
+            munmap(base, mapped_size);
+        }
+        base = std::exchange(other.base, nullptr);
+        mapped_size = std::exchange(other.mapped_size, 0);
+        decls = std::exchange(other.decls, {});
+        params = std::exchange(other.params, {});
+        annotations = std::exchange(other.annotations, {});
+        exports = std::exchange(other.exports, {});
+        imports = std::exchange(other.imports, {});
+        strings = std::exchange(other.strings, {});
+    }
+    return *this;
+}
+
+nightglow::lang::precompiled::MappedModule::~MappedModule()
+{
+    if (base)
+    {
+        munmap(base, mapped_size);
+    }
+}
+
+uint32_t nightglow::lang::precompiled::MappedModule::find(const std::string_view name) const
+{
+    const auto name_of = [this](const uint32_t index) { return index < decls.size() ? string(decls[index].name) : std::string_view{}; };
+    const auto it = std::ranges::lower_bound(exports, name, {}, name_of);
+    return it != exports.end() && name_of(*it) == name ? *it : no_decl;
+}
+
+nightglow::lang::precompiled::declaration nightglow::lang::precompiled::MappedModule::materialize(const uint32_t index) const
+{
+    if (index >= decls.size())
+        return { node_kind::ERROR, {}, {}, 0, 0, no_decl, {}, {} };
+    const decl_record& record = decls[index];
+    declaration decl{ record.kind, string(record.name), string(record.type), record.flags, record.line, record.parent, {}, {} };
+
+    // a corrupt range yields fewer entries, never a read outside the mapping
+    const size_t first_param = std::min<size_t>(record.first_param, params.size());
+    for (const param_record& param : params.subspan(first_param, std::min<size_t>(record.param_count, params.size() - first_param)))
+    {
+        decl.params.push_back({ string(param.name), string(param.type), param.has_default != 0 });
+    }
+    const size_t first_annotation = std::min<size_t>(record.first_annotation, annotations.size());
+    for (const string_ref annotation : annotations.subspan(first_annotation, std::min<size_t>(record.annotation_count, annotations.size() - first_annotation)))
+    {
+        decl.annotations.push_back(string(annotation));
+    }
+    return decl;
+}
+
+nightglow::lang::precompiled::Interface nightglow::lang::precompiled::extract(const lexer::Lexer& lexer, const ast::Ast& ast)
+{
+    Interface exported;
+    if (ast.root == ast::no_node)
+        return exported;
+    extractor walker{ lexer, ast, exported };
+    for (const node_id statement : ast.children(ast.root))
+    {
+        // the name of an import is the tokens between the keyword and the ;
+        if (ast.kind(statement) == node_kind::IMPORT && ast.end(statement) > ast.begin(statement) + 2
+            && lexer.tokens.types[ast.end(statement) - 1] == token_i::SEMICOLON)
+            exported.imports.push_back(spell(lexer, exported, ast.begin(statement) + 1, ast.end(statement) - 1));
+        walker.add(statement, no_decl);
+    }
+    return exported;
+}
+
+nightglow::lang::precompiled::Interface nightglow::lang::precompiled::scan(const lexer::Lexer& lexer)
+{
+    NIGHTGLOW_TRACE_SCOPE("scan_interface");
+    Interface exported;
+    if (lexer.tokens.size() == 0)
+        return exported;
+    skimmer skim{ lexer, lexer.tokens.types.data(), static_cast<uint32_t>(lexer.tokens.size() - 1), exported };
+    while (skim.peek() == token_i::IMPORT)
+    {
+        skim.import();
+    }
+    while (skim.pos < skim.eof)
+    {
+        skim.statement(no_decl);
+    }
+    return exported;
+}
+
+std::filesystem::path nightglow::lang::precompiled::module_path(const std::filesystem::path& dir, const std::string_view src)
+{
+    const uint64_t key = cache::hash_source(src) ^ (static_cast<uint64_t>(format_version) << 32 | src.size());
+
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.ngmod", static_cast<unsigned long long>(key));
+    return dir / name;
+}
+
+bool nightglow::lang::precompiled::write(const std::filesystem::path& path, const Interface& exported, const std::string_view src)
+{
+    memory::vector<uint32_t> exports;
+    for (uint32_t i = 0; i < exported.decls.size(); ++i)
+    {
+        if (exported.decls[i].parent == no_decl)
+            exports.push_back(i);
+    }
+    std::ranges::stable_sort(exports, {}, [&exported](const uint32_t i) { return exported.string(exported.decls[i].name); });
+
+    module_header header{};
+    std::memcpy(header.magic, module_magic, sizeof(module_magic));
+    header.endian_tag = module_endian_tag;
+    header.format_version = format_version;
+    header.source_length = static_cast<uint32_t>(src.size());
+    header.source_hash = cache::hash_source(src);
+    header.decl_count = static_cast<uint32_t>(exported.decls.size());
+    header.param_count = static_cast<uint32_t>(exported.params.size());
+    header.annotation_count = static_cast<uint32_t>(exported.annotations.size());
+    header.export_count = static_cast<uint32_t>(exports.size());
+    header.string_bytes = static_cast<uint32_t>(exported.strings.size());
+    header.import_count = static_cast<uint32_t>(exported.imports.size());
+    header.decls_offset = align_up(sizeof(module_header));
+    header.params_offset = align_up(header.decls_offset + header.decl_count * sizeof(decl_record));
+    header.annotations_offset = align_up(header.params_offset + header.param_count * sizeof(param_record));
+    header.exports_offset = align_up(header.annotations_offset + header.annotation_count * sizeof(string_ref));
+    header.imports_offset = align_up(header.exports_offset + header.export_count * sizeof(uint32_t));
+    header.strings_offset = align_up(header.imports_offset + header.import_count * sizeof(string_ref));
+
+    return binary_file::write_atomically(path, [&](std::ofstream& out)
+    {
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_table(out, exported.decls.data(), header.decl_count * sizeof(decl_record), header.decls_offset);
+        write_table(out, exported.params.data(), header.param_count * sizeof(param_record), header.params_offset);
+        write_table(out, exported.annotations.data(), header.annotation_count * sizeof(string_ref), header.annotations_offset);
+        write_table(out, exports.data(), header.export_count * sizeof(uint32_t), header.exports_offset);
+        write_table(out, exported.imports.data(), header.import_count * sizeof(string_ref), header.imports_offset);
+        write_table(out, exported.strings.data(), header.string_bytes, header.strings_offset);
+    });
+}
+
+bool nightglow::lang::precompiled::store(const std::filesystem::path& dir, const lexer::Lexer& lexer, const ast::Ast& ast)
+{
+    if (ast.root == ast::no_node || ast.errors.size() != 0)
+    {
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec)
+    {
+        return false;
+    }
+    const std::string_view src(lexer.src, lexer.src_length);
+    return write(module_path(dir, src), extract(lexer, ast), src);
+}
+
+std::optional<nightglow::lang::precompiled::MappedModule> nightglow::lang::precompiled::load(const std::filesystem::path& dir, const std::string_view src)
+{
+    const int fd = open(module_path(dir, src).c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(module_header))
+    {
+        close(fd);
+        return std::nullopt;
+    }
+
+    const auto file_size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return std::nullopt;
+    }
+
+    MappedModule mapped;
+    mapped.base = base;
+    mapped.mapped_size = file_size;
+
+    const auto* header = static_cast<const module_header*>(base);
+    if (std::memcmp(header->magic, module_magic, sizeof(module_magic)) != 0
+        || header->endian_tag != module_endian_tag
+        || header->format_version != format_version
+        || header->source_length != src.size()
+        || header->source_hash != cache::hash_source(src))
+    {
+        return std::nullopt;
+    }
+
+    if (!table_in_bounds(header->decls_offset, header->decl_count, sizeof(decl_record), file_size)
+        || !table_in_bounds(header->params_offset, header->param_count, sizeof(param_record), file_size)
+        || !table_in_bounds(header->annotations_offset, header->annotation_count, sizeof(string_ref), file_size)
+        || !table_in_bounds(header->exports_offset, header->export_count, sizeof(uint32_t), file_size)
+        || !table_in_bounds(header->imports_offset, header->import_count, sizeof(string_ref), file_size)
+        || !table_in_bounds(header->strings_offset, header->string_bytes, 1, file_size))
+    {
+        return std::nullopt;
+    }
+
+    const auto* bytes = static_cast<const char*>(base);
+    mapped.decls = { reinterpret_cast<const decl_record*>(bytes + header->decls_offset), header->decl_count };
+    mapped.params = { reinterpret_cast<const param_record*>(bytes + header->params_offset), header->param_count };
+    mapped.annotations = { reinterpret_cast<const string_ref*>(bytes + header->annotations_offset), header->annotation_count };
+    mapped.exports = { reinterpret_cast<const uint32_t*>(bytes + header->exports_offset), header->export_count };
+    mapped.imports = { reinterpret_cast<const string_ref*>(bytes + header->imports_offset), header->import_count };
+    mapped.strings = { bytes + header->strings_offset, header->string_bytes };
+    return mapped;
+}
@@ -0,0 +1,234 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/token_cache.h"
+#include "binary_file.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace
+{
+    constexpr char cache_magic[8] = { 'N', 'G', 'T', 'O', 'K', 'C', 0, 0 };
+    constexpr uint32_t cache_endian_tag = 0x01020304;
+
+    uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        return x ^ (x >> 33);
+    }
+
+    uint64_t align_up(const uint64_t offset)
+    {
+        return nightglow::lang::binary_file::align_up(offset, nightglow::lang::cache::column_alignment);
+    }
+
+    bool column_in_bounds(const uint64_t offset, const uint64_t count, const uint64_t element_size, const size_t file_size)
+    {
+        return offset % alignof(uint32_t) == 0 && offset <= file_size && count * element_size <= file_size - offset;
+    }
+
+    void write_column(std::ofstream& out, const void* data, const uint64_t bytes, const uint64_t offset)
+    {
+        nightglow::lang::binary_file::write_table<nightglow::lang::cache::column_alignment>(out, data, bytes, offset);
+    }
+}
+
+nightglow::lang::cache::MappedTokens::MappedTokens(MappedTokens&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+nightglow::lang::cache::MappedTokens& nightglow::lang::cache::MappedTokens::operator=(MappedTokens&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (base)
+        {
+            munmap(base, mapped_size);
+        }
+        base = std::exchange(other.base, nullptr);
+        mapped_size = std::exchange(other.mapped_size, 0);
+        starts = std::exchange(other.starts, {});
+        lengths = std::exchange(other.lengths, {});
+        types = std::exchange(other.types, {});
+        flags = std::exchange(other.flags, {});
+        line_starts = std::exchange(other.line_starts, {});
+    }
+    return *this;
+}
+
+nightglow::lang::cache::MappedTokens::~MappedTokens()
+{
+    if (base)
+    {
+        munmap(base, mapped_size);
+    }
+}
+
+uint64_t nightglow::lang::cache::hash_source(const std::string_view src)
+{
+    // MurmurHash64A; eight bytes per step keeps the warm path close to memory bandwidth
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+    constexpr int r = 47;
+    const char* data = src.data();
+    const size_t length = src.size();
+    uint64_t h = 0xe17a1465ULL ^ (length * m);
+
+    const char* end = data + (length & ~static_cast<size_t>(7));
+    for (; data != end; data += 8)
+    {
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    if (const size_t tail = length & 7; tail != 0)
+    {
+        uint64_t k = 0;
+        std::memcpy(&k, data, tail);
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+std::filesystem::path nightglow::lang::cache::cache_path(const std::filesystem::path& dir, const std::string_view src)
+{
+    const uint64_t versions = static_cast<uint64_t>(lexer::lexer_version) << 32 | format_version;
+    const uint64_t key = hash_source(src) ^ mix(versions ^ src.size());
+
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.ngtok", static_cast<unsigned long long>(key));
+    return dir / name;
+}
+
+bool nightglow::lang::cache::write(const std::filesystem::path& path, const lexer::Lexer& lexer)
+{
+    const std::string_view src(lexer.src, lexer.src_length);
+    const TokenList& tokens = lexer.tokens;
+
+    cache_header header{};
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.endian_tag = cache_endian_tag;
+    header.format_version = format_version;
+    header.lexer_version = lexer::lexer_version;
+    header.source_length = lexer.src_length;
+    header.source_hash = hash_source(src);
+    header.token_count = static_cast<uint32_t>(tokens.size());
+    header.line_count = static_cast<uint32_t>(lexer.line_starts.size());
+    header.starts_offset = align_up(sizeof(cache_header));
+    header.lengths_offset = align_up(header.starts_offset + header.token_count * sizeof(uint32_t));
+    header.types_offset = align_up(header.lengths_offset + header.token_count * sizeof(uint16_t));
+    header.flags_offset = align_up(header.types_offset + header.token_count * sizeof(token_i));
+    header.line_starts_offset = align_up(header.flags_offset + header.token_count * sizeof(uint8_t));
+
+    return binary_file::write_atomically(path, [&](std::ofstream& out)
+    {
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write_column(out, tokens.starts.data(), header.token_count * sizeof(uint32_t), header.starts_offset);
+        write_column(out, tokens.lengths.data(), header.token_count * sizeof(uint16_t), header.lengths_offset);
+        write_column(out, tokens.types.data(), header.token_count * sizeof(token_i), header.types_offset);
+        write_column(out, tokens.flags.data(), header.token_count * sizeof(uint8_t), header.flags_offset);
+        write_column(out, lexer.line_starts.data(), header.line_count * sizeof(uint32_t), header.line_starts_offset);
+    });
+}
+
+bool nightglow::lang::cache::store(const std::filesystem::path& dir, const lexer::Lexer& lexer)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec)
+    {
+        return false;
+    }
+    return write(cache_path(dir, std::string_view(lexer.src, lexer.src_length)), lexer);
+}
+
+std::optional<nightglow::lang::cache::MappedTokens> nightglow::lang::cache::load(const std::filesystem::path& dir, const std::string_view src)
+{
+    const int fd = open(cache_path(dir, src).c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return std::nullopt;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(cache_header))
+    {
+        close(fd);
+        return std::nullopt;
+    }
+
+    const auto file_size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return std::nullopt;
+    }
+
+    MappedTokens mapped;
+    mapped.base = base;
+    mapped.mapped_size = file_size;
+
+    const auto* header = static_cast<const cache_header*>(base);
+    if (std::memcmp(header->magic, cache_magic, sizeof(cache_magic)) != 0
+        || header->endian_tag != cache_endian_tag
+        || header->format_version != format_version
+        || header->lexer_version != lexer::lexer_version
+        || header->source_length != src.size()
+        || header->source_hash != hash_source(src))
+    {
+        return std::nullopt;
+    }
+
+    const uint64_t count = header->token_count;
+    if (!column_in_bounds(header->starts_offset, count, sizeof(uint32_t), file_size)
+        || !column_in_bounds(header->lengths_offset, count, sizeof(uint16_t), file_size)
+        || !column_in_bounds(header->types_offset, count, sizeof(token_i), file_size)
+        || !column_in_bounds(header->flags_offset, count, sizeof(uint8_t), file_size)
+        || !column_in_bounds(header->line_starts_offset, header->line_count, sizeof(uint32_t), file_size))
+    {
+        return std::nullopt;
+    }
+
+    madvise(base, file_size, MADV_WILLNEED);
+
+    const auto* bytes = static_cast<const char*>(base);
+    mapped.starts = { reinterpret_cast<const uint32_t*>(bytes + header->starts_offset), count };
+    mapped.lengths = { reinterpret_cast<const uint16_t*>(bytes + header->lengths_offset), count };
+    mapped.types = { reinterpret_cast<const token_i*>(bytes + header->types_offset), count };
+    mapped.flags = { reinterpret_cast<const uint8_t*>(bytes + header->flags_offset), count };
+    mapped.line_starts = { reinterpret_cast<const uint32_t*>(bytes + header->line_starts_offset), header->line_count };
+    return mapped;
+}
+
+nightglow::lang::TokenList nightglow::lang::cache::to_token_list(const MappedTokens& mapped)
+{
+    TokenList tokens;
+    tokens.starts.assign(mapped.starts.begin(), mapped.starts.end());
+    tokens.lengths.assign(mapped.lengths.begin(), mapped.lengths.end());
+    tokens.types.assign(mapped.types.begin(), mapped.types.end());
+    tokens.flags.assign(mapped.flags.begin(), mapped.flags.end());
+    return tokens;
+}
@@ -0,0 +1,219 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+#include "../include/token_packed.h"
+#include <bit>
+
+namespace
+{
+    using nightglow::lang::packed::block_size;
+
+    // values per lane; the block is split into 4 lanes so value i lives in lane i % 4, slot i / 4
+    constexpr uint32_t lane_count = 4;
+    constexpr uint32_t slots = block_size / lane_count;
+
+    uint8_t bits_for(const uint32_t value)
+    {
+        return static_cast<uint8_t>(32 - std::countl_zero(value));
+    }
+
+    uint8_t pack(const uint32_t* values, nightglow::lang::memory::vector<uint32_t>& words)
+    {
+        uint32_t all = 0;
+        for (uint32_t i = 0; i < block_size; ++i)
+        {
+            all |= values[i];
+        }
+
+        const uint8_t width = bits_for(all);
+        if (width == 0)
+        {
+            return 0;
+        }
+
+        const size_t base = words.size();
+        words.resize(base + lane_count * width);
+        uint32_t* out = words.data() + base;
+        for (uint32_t slot = 0; slot < slots; ++slot)
+        {
+            const uint32_t bit = slot * width;
+            const uint32_t word = bit / 32;
+            const uint32_t shift = bit % 32;
+            for (uint32_t lane = 0; lane < lane_count; ++lane)
+            {
+                const uint32_t value = values[slot * lane_count + lane];
+                out[word * lane_count + lane] |= value << shift;
+                if (shift + width > 32)
+                {
+                    out[(word + 1) * lane_count + lane] |= value >> (32 - shift);
+                }
+            }
+        }
+        return width;
+    }
+
+    void unpack(const uint32_t* in, const uint8_t width, uint32_t* values)
+    {
+        if (width == 0)
+        {
+            std::fill_n(values, block_size, 0);
+            return;
+        }
+
+        const uint32_t mask = width == 32 ? UINT32_MAX : (1u << width) - 1;
+
+        #if defined(__SSE2__)
+        const __m128i mask_vec = _mm_set1_epi32(static_cast<int>(mask));
+        for (uint32_t slot = 0; slot < slots; ++slot)
+        {
+            const uint32_t bit = slot * width;
+            const uint32_t word = bit / 32;
+            const uint32_t shift = bit % 32;
+
+            __m128i value = _mm_srl_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + word * lane_count)),
+                _mm_cvtsi32_si128(static_cast<int>(shift)));
+            if (shift + width > 32)
+            {
+                const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + (word + 1) * lane_count));
+                value = _mm_or_si128(value, _mm_sll_epi32(next, _mm_cvtsi32_si128(static_cast<int>(32 - shift))));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + slot * lane_count), _mm_and_si128(value, mask_vec));
+        }
+        #elif defined(__ARM_NEON)
+        const uint32x4_t mask_vec = vdupq_n_u32(mask);
+        for (uint32_t slot = 0; slot < slots; ++slot)
+        {
+            const uint32_t bit = slot * width;
+            const uint32_t word = bit / 32;
+            const uint32_t shift = bit % 32;
+
+            uint32x4_t value = vshlq_u32(vld1q_u32(in + word * lane_count), vdupq_n_s32(-static_cast<int32_t>(shift)));
+            if (shift + width > 32)
+            {
+                const uint32x4_t next = vld1q_u32(in + (word + 1) * lane_count);
+                value = vorrq_u32(value, vshlq_u32(next, vdupq_n_s32(static_cast<int32_t>(32 - shift))));
+            }
+            vst1q_u32(values + slot * lane_count, vandq_u32(value, mask_vec));
+        }
+        #else
+        for (uint32_t slot = 0; slot < slots; ++slot)
+        {
+            const uint32_t bit = slot * width;
+            const uint32_t word = bit / 32;
+            const uint32_t shift = bit % 32;
+            for (uint32_t lane = 0; lane < lane_count; ++lane)
+            {
+                uint32_t value = in[word * lane_count + lane] >> shift;
+                if (shift + width > 32)
+                {
+                    value |= in[(word + 1) * lane_count + lane] << (32 - shift);
+                }
+                values[slot * lane_count + lane] = value & mask;
+            }
+        }
+        #endif
+    }
+}
+
+nightglow::lang::packed::PackedTokenList nightglow::lang::packed::compress(const TokenList& tokens)
+{
+    PackedTokenList packed;
+    packed.count = static_cast<uint32_t>(tokens.size());
+    packed.blocks.reserve((packed.count + block_size - 1) / block_size);
+
+    alignas(16) uint32_t gaps[block_size];
+    alignas(16) uint32_t lengths[block_size];
+    alignas(16) uint32_t types[block_size];
+    alignas(16) uint32_t flags[block_size];
+
+    for (uint32_t first = 0; first < packed.count; first += block_size)
+    {
+        const uint32_t n = std::min(block_size, packed.count - first);
+        std::fill_n(gaps, block_size, 0);
+        std::fill_n(lengths, block_size, 0);
+        std::fill_n(types, block_size, 0);
+        std::fill_n(flags, block_size, 0);
+
+        // gaps wrap on purpose so overlapping or out-of-order tokens still round trip, just at a wider width
+        uint32_t end = tokens.starts[first];
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            gaps[i] = tokens.starts[first + i] - end;
+            lengths[i] = tokens.lengths[first + i];
+            types[i] = static_cast<uint32_t>(tokens.types[first + i]);
+            flags[i] = tokens.flags[first + i];
+            end = tokens.starts[first + i] + tokens.lengths[first + i];
+        }
+
+        block_header header{};
+        header.first_start = tokens.starts[first];
+        header.word_offset = static_cast<uint32_t>(packed.words.size());
+        header.gap_bits = pack(gaps, packed.words);
+        header.length_bits = pack(lengths, packed.words);
+        header.type_bits = pack(types, packed.words);
+        header.flag_bits = pack(flags, packed.words);
+        packed.blocks.push_back(header);
+    }
+
+    packed.words.shrink_to_fit();
+    return packed;
+}
+
+void nightglow::lang::packed::decode_block(const PackedTokenList& packed, const size_t index, token_block& out)
+{
+    const block_header& header = packed.blocks[index];
+    const uint32_t* in = packed.words.data() + header.word_offset;
+
+    alignas(16) uint32_t gaps[block_size];
+    alignas(16) uint32_t lengths[block_size];
+    alignas(16) uint32_t types[block_size];
+    alignas(16) uint32_t flags[block_size];
+
+    unpack(in, header.gap_bits, gaps);
+    in += lane_count * header.gap_bits;
+    unpack(in, header.length_bits, lengths);
+    in += lane_count * header.length_bits;
+    unpack(in, header.type_bits, types);
+    in += lane_count * header.type_bits;
+    unpack(in, header.flag_bits, flags);
+
+    out.size = std::min(block_size, packed.count - static_cast<uint32_t>(index) * block_size);
+
+    uint32_t end = header.first_start;
+    for (uint32_t i = 0; i < out.size; ++i)
+    {
+        out.starts[i] = end + gaps[i];
+        end = out.starts[i] + lengths[i];
+    }
+    for (uint32_t i = 0; i < block_size; ++i)
+    {
+        out.lengths[i] = static_cast<uint16_t>(lengths[i]);
+        out.types[i] = static_cast<token_i>(types[i]);
+        out.flags[i] = static_cast<uint8_t>(flags[i]);
+    }
+}
+
+nightglow::lang::TokenList nightglow::lang::packed::decompress(const PackedTokenList& packed)
+{
+    TokenList tokens;
+    tokens.reserve(packed.count);
+    for_each_block(packed, [&tokens](const token_block& block)
+    {
+        tokens.starts.insert(tokens.starts.end(), block.starts, block.starts + block.size);
+        tokens.lengths.insert(tokens.lengths.end(), block.lengths, block.lengths + block.size);
+        tokens.types.insert(tokens.types.end(), block.types, block.types + block.size);
+        tokens.flags.insert(tokens.flags.end(), block.flags, block.flags + block.size);
+    });
+    return tokens;
+}
@@ -0,0 +1,169 @@
+//
+// Created by: Al++, 19.10.2026
+// This header file is a part of the Nightglow programming language, licensed under the MIT license.
+//
+
+#include "../include/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct event
+    {
+        const char* name;
+        uint64_t begin_ns;
+        uint64_t duration_ns;
+        std::string detail;
+    };
+
+    struct thread_buffer
+    {
+        uint32_t id;
+        std::string name;
+        std::vector<event> events;
+    };
+
+    // buffers are owned by the registry so they outlive the threads that filled them
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<thread_buffer>> registry;
+
+    thread_buffer& local_buffer()
+    {
+        thread_local thread_buffer* buffer = []
+        {
+            std::lock_guard lock(registry_mutex);
+            const auto id = static_cast<uint32_t>(registry.size());
+            registry.push_back(std::make_unique<thread_buffer>(thread_buffer{ id, id == 0 ? "main" : "thread " + std::to_string(id), {} }));
+            return registry.back().get();
+        }();
+        return *buffer;
+    }
+
+    void write_json_string(std::ostream& out, const std::string_view text)
+    {
+        out << '"';
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out << escaped;
+            }
+            else
+                out << c;
+        }
+        out << '"';
+    }
+}
+
+void nightglow::lang::trace::enable()
+{
+    static_cast<void>(now_ns());
+    static_cast<void>(local_buffer());
+    active.store(true, std::memory_order_relaxed);
+}
+
+uint64_t nightglow::lang::trace::now_ns()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void nightglow::lang::trace::set_thread_name(const std::string_view name)
+{
+    if (!enabled())
+        return;
+    local_buffer().name = name;
+}
+
+void nightglow::lang::trace::record(const char* name, const uint64_t begin_ns, const uint64_t duration_ns, const std::string_view detail)
+{
+    local_buffer().events.push_back({ name, begin_ns, duration_ns, std::string(detail) });
+}
+
+bool nightglow::lang::trace::write_chrome_trace(const std::filesystem::path& path)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    std::lock_guard lock(registry_mutex);
+    out << "{\"traceEvents\":[\n";
+    auto first = true;
+    for (const auto& buffer : registry)
+    {
+        out << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->id << R"(,"args":{"name":)";
+        write_json_string(out, buffer->name);
+        out << "}}";
+        first = false;
+
+        for (const event& e : buffer->events)
+        {
+            char times[96];
+            std::snprintf(times, sizeof(times), R"("ts":%.3f,"dur":%.3f)", static_cast<double>(e.begin_ns) / 1e3, static_cast<double>(e.duration_ns) / 1e3);
+            out << ",\n{\"name\":";
+            write_json_string(out, e.name);
+            out << R"(,"cat":"nightglow","ph":"X",)" << times << R"(,"pid":1,"tid":)" << buffer->id;
+            if (!e.detail.empty())
+            {
+                out << R"(,"args":{"detail":)";
+                write_json_string(out, e.detail);
+                out << '}';
+            }
+            out << '}';
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
+
+void nightglow::lang::trace::print_time_passes(std::ostream& out)
+{
+    struct pass
+    {
+        uint64_t calls = 0;
+        uint64_t total_ns = 0;
+    };
+
+    std::map<std::string_view, pass> passes;
+    {
+        std::lock_guard lock(registry_mutex);
+        for (const auto& buffer : registry)
+        {
+            for (const event& e : buffer->events)
+            {
+                pass& p = passes[e.name];
+                ++p.calls;
+                p.total_ns += e.duration_ns;
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string_view, pass>> sorted(passes.begin(), passes.end());
+    std::ranges::sort(sorted, [](const auto& a, const auto& b) { return a.second.total_ns > b.second.total_ns; });
+
+    const double wall_ms = static_cast<double>(now_ns()) / 1e6;
+    char line[160];
+    std::snprintf(line, sizeof(line), "===-- Nightglow time passes (wall %.3f ms) --===\n", wall_ms);
+    out << line;
+    std::snprintf(line, sizeof(line), "%12s %10s %12s %8s  %s\n", "total ms", "calls", "mean us", "% wall", "name");
+    out << line;
+    for (const auto& [name, p] : sorted)
+    {
+        const double total_ms = static_cast<double>(p.total_ns) / 1e6;
+        std::snprintf(line, sizeof(line), "%12.3f %10llu %12.3f %7.1f%%  %.*s\n", total_ms, static_cast<unsigned long long>(p.calls),
+                      static_cast<double>(p.total_ns) / 1e3 / static_cast<double>(p.calls),
+                      wall_ms > 0 ? total_ms / wall_ms * 100.0 : 0.0, static_cast<int>(name.size()), name.data());
+        out << line;
+    }
+}
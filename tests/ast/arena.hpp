@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include "../../lang/include/ast.h"
+
+inline void ast_arena()
+{
+    using namespace nightglow::lang;
+    constexpr std::string_view input = "a + b * c;";
+    auto lexer = lexer::create_lexer(input, input.size());
+    lexer::tokenize(lexer);
+
+    try
+    {
+        ast::Ast tree;
+        const ast::node_id a = tree.add(ast::node_kind::IDENTIFIER, 0, 0, 1);
+        const ast::node_id b = tree.add(ast::node_kind::IDENTIFIER, 2, 2, 3);
+        const ast::node_id c = tree.add(ast::node_kind::IDENTIFIER, 4, 4, 5);
+        const ast::node_id product[] = { b, c };
+        const ast::node_id mul = tree.add(ast::node_kind::BINARY, 3, 2, 5, product);
+        const ast::node_id sum[] = { a, mul };
+        tree.root = tree.add(ast::node_kind::BINARY, 1, 0, 5, sum);
+
+        assert(tree.size() == 5);
+        assert(tree.kind(tree.root) == ast::node_kind::BINARY);
+        assert(lexer.tokens.type(tree.token(tree.root)) == token_i::PLUS);
+        assert(tree.children(tree.root).size() == 2);
+        assert(tree.children(tree.root)[1] == mul);
+        assert(tree.children(mul)[0] == b && tree.children(mul)[1] == c);
+        assert(tree.children(a).empty());
+
+        std::ostringstream out;
+        ast::dump(out, tree, lexer);
+        assert(out.str() == "BINARY '+' [0, 5)\n  IDENTIFIER 'a' [0, 1)\n  BINARY '*' [2, 5)\n    IDENTIFIER 'b' [2, 3)\n    IDENTIFIER 'c' [4, 5)\n");
+
+        // many nodes still come from a handful of chunks and go away at once
+        const ast::node_id pair[] = { a, b };
+        for (auto i = 0; i < 100000; ++i)
+        {
+            tree.add(ast::node_kind::BINARY, 1, 0, 5, pair);
+        }
+        assert(tree.size() == 100005);
+        assert(tree.children(100004)[1] == b);
+
+        uint32_t chunks = 0;
+        for (const memory::Arena::chunk* chunk = tree.arena.head; chunk != nullptr; chunk = chunk->next)
+            ++chunks;
+        assert(chunks < 16);
+
+        tree.clear();
+        assert(tree.size() == 0 && tree.root == ast::no_node);
+        assert(tree.arena.bytes_used() == 0);
+        assert(tree.arena.head != nullptr && tree.arena.head->next == nullptr);
+
+        std::cout << GREEN << "[PASSED]: AST arena\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../../lang/include/parser.h"
+#include "../../lang/include/precompiled.h"
+
+inline void module_roundtrip()
+{
+    using namespace nightglow::lang;
+    constexpr std::string_view input = "import core.io;\n"
+                                       "@pure\n"
+                                       "public inline function add(a: i32, b: i32 = 2) -> i32 { return a + b; }\n"
+                                       "class Point extends Base { public var x: f64 = 0; private var y: f64; function len() -> f64; }\n"
+                                       "enum Color { RED, GREEN = 2 }\n"
+                                       "const limit: u32 = 10;\n";
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "nightglow-module-test";
+    std::filesystem::remove_all(dir);
+
+    try
+    {
+        auto lexer = lexer::create_lexer(input.data(), input.size());
+        lexer::tokenize(lexer);
+        parser::parse_options options;
+        options.lazy_bodies = true;
+        const ast::Ast tree = parser::parse(lexer, options);
+
+        assert(!precompiled::load(dir, input).has_value());
+        [[maybe_unused]] const bool stored = precompiled::store(dir, lexer, tree);
+        assert(stored);
+
+        const auto mapped = precompiled::load(dir, input);
+        if (!mapped.has_value())
+            throw std::runtime_error("module file was not loaded");
+        assert(mapped->decls.size() == 8 && mapped->exports.size() == 4);
+        assert(mapped->imports.size() == 1 && mapped->string(mapped->imports[0]) == "core.io");
+        assert(mapped->find("missing") == precompiled::no_decl);
+
+        [[maybe_unused]] const auto add = mapped->materialize(mapped->find("add"));
+        assert(add.kind == ast::node_kind::FUNCTION && add.type == "i32" && add.line == 3);
+        assert(add.flags == (precompiled::PUBLIC | precompiled::INLINE | precompiled::HAS_BODY));
+        assert(add.params.size() == 2 && add.params[1].name == "b" && add.params[1].type == "i32");
+        assert(!add.params[0].has_default && add.params[1].has_default);
+        assert(add.annotations.size() == 1 && add.annotations[0] == "@pure");
+
+        // members follow their class; private ones are left out
+        const uint32_t point = mapped->find("Point");
+        assert(mapped->materialize(point).type == "Base");
+        [[maybe_unused]] const auto x = mapped->materialize(point + 1);
+        assert(x.name == "x" && x.parent == point && x.type == "f64" && x.flags == precompiled::PUBLIC);
+        [[maybe_unused]] const auto len = mapped->materialize(point + 2);
+        assert(len.name == "len" && len.parent == point && len.flags == 0);
+
+        [[maybe_unused]] const auto green = mapped->materialize(mapped->find("Color") + 2);
+        assert(green.name == "GREEN" && green.kind == ast::node_kind::VARIABLE);
+        assert(mapped->materialize(mapped->find("limit")).flags == precompiled::CONSTANT);
+
+        // an index past the table, no_decl included, gives an empty declaration
+        [[maybe_unused]] const auto none = mapped->materialize(precompiled::no_decl);
+        assert(none.kind == ast::node_kind::ERROR && none.name.empty() && none.parent == precompiled::no_decl && none.params.empty());
+        assert(mapped->materialize(static_cast<uint32_t>(mapped->decls.size())).name.empty());
+
+        // writers racing on one file each get their own temporary, and leave only the whole file behind
+        const precompiled::Interface exported = precompiled::extract(lexer, tree);
+        std::atomic<int> written = 0;
+        {
+            std::vector<std::jthread> writers;
+            for (auto i = 0; i < 8; ++i)
+            {
+                writers.emplace_back([&] { written += precompiled::write(precompiled::module_path(dir, input), exported, input); });
+            }
+        }
+        assert(written == 8 && precompiled::load(dir, input).has_value());
+        assert(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 1);
+
+        // an edited source misses, and a broken one is never stored
+        [[maybe_unused]] constexpr std::string_view edited = "const limit: u32 = 11;\n";
+        assert(!precompiled::load(dir, edited).has_value());
+        constexpr std::string_view broken = "function f( { }\n";
+        auto broken_lexer = lexer::create_lexer(broken.data(), broken.size());
+        lexer::tokenize(broken_lexer);
+        [[maybe_unused]] const bool stored_broken = precompiled::store(dir, broken_lexer, parser::parse(broken_lexer));
+        assert(!stored_broken);
+        assert(!precompiled::load(dir, broken).has_value());
+
+        std::filesystem::remove_all(dir);
+        std::cout << GREEN << "[PASSED]: Precompiled module round trip\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
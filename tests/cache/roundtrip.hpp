@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include "../../lang/include/token_cache.h"
+
+inline void cache_roundtrip()
+{
+    constexpr std::string_view input = "function main() -> void\n{\n    return;\n}\n";
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "nightglow-cache-test";
+    std::filesystem::remove_all(dir);
+
+    auto lexer = nightglow::lang::lexer::create_lexer(input.data(), input.size());
+    [[maybe_unused]] const nightglow::lang::TokenList* tokens = tokenize(lexer);
+
+    try
+    {
+        assert(!nightglow::lang::cache::load(dir, input).has_value());
+        [[maybe_unused]] const bool stored = nightglow::lang::cache::store(dir, lexer);
+        assert(stored);
+
+        [[maybe_unused]] const auto mapped = nightglow::lang::cache::load(dir, input);
+        assert(mapped.has_value());
+        assert(mapped->size() == tokens->size());
+        assert(std::ranges::equal(mapped->starts, tokens->starts));
+        assert(std::ranges::equal(mapped->lengths, tokens->lengths));
+        assert(std::ranges::equal(mapped->types, tokens->types));
+        assert(std::ranges::equal(mapped->flags, tokens->flags));
+        assert(std::ranges::equal(mapped->line_starts, lexer.line_starts));
+
+        [[maybe_unused]] constexpr std::string_view edited = "function main() -> void\n{\n    return 0;\n}\n";
+        assert(!nightglow::lang::cache::load(dir, edited).has_value());
+
+        std::filesystem::remove_all(dir);
+        std::cout << GREEN << "[PASSED]: Token cache round trip\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -2,7 +2,7 @@
 
 #include <cassert>
 #include <iostream>
-#include "../lang/include/lexer.h"
+#include "../../lang/include/lexer.h"
 
 constexpr auto RESET = "\033[0m";
 constexpr auto RED = "\033[31m";
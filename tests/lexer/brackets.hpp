@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../../lang/include/parser.h"
+
+inline void bracket_matching()
+{
+    using namespace nightglow::lang;
+    try
+    {
+        // tokens: f ( a [ 0 ] ) { } ;
+        const std::string balanced = "f(a[0]){};";
+        auto lexer = lexer::create_lexer(balanced, balanced.size());
+        lexer.match_brackets = true;
+        [[maybe_unused]] const TokenList* tokens = lexer::tokenize(lexer);
+        assert(tokens->matches.size() == tokens->size());
+        assert(tokens->matches[1] == 6 && tokens->matches[6] == 1);
+        assert(tokens->matches[3] == 5 && tokens->matches[5] == 3);
+        assert(tokens->matches[7] == 8 && tokens->matches[8] == 7);
+        assert(tokens->matches[0] == no_match && tokens->matches[9] == no_match);
+        assert(tokens->unmatched.empty());
+
+        // off by default
+        auto plain = lexer::create_lexer(balanced, balanced.size());
+        assert(lexer::tokenize(plain)->matches.empty());
+
+        // tokens: { ( ] } ) [
+        const std::string broken = "{ ( ] } ) [";
+        auto mismatched = lexer::create_lexer(broken, broken.size());
+        mismatched.match_brackets = true;
+        [[maybe_unused]] const TokenList* bad = lexer::tokenize(mismatched);
+        assert(bad->matches[0] == 3 && bad->matches[3] == 0);
+        assert((bad->unmatched == memory::vector<uint32_t>{ 1, 2, 4, 5 }));
+        assert(bad->matches[1] == no_match && bad->matches[5] == no_match);
+
+        // closers with no opener of their kind under a deep stack of another kind stay linear
+        const std::string deep = std::string(100000, '(') + std::string(100000, ']');
+        auto crossed = lexer::create_lexer(deep, deep.size());
+        crossed.match_brackets = true;
+        [[maybe_unused]] const TokenList* none = lexer::tokenize(crossed);
+        assert(none->unmatched.size() == deep.size());
+        assert(none->unmatched.front() == 0 && none->unmatched.back() == deep.size() - 1);
+
+        // reset_lexer drops the previous columns
+        lexer::reset_lexer(mismatched, balanced, balanced.size());
+        lexer::tokenize(mismatched);
+        assert(mismatched.tokens.matches.size() == mismatched.tokens.size() && mismatched.tokens.unmatched.empty());
+
+        // lazy bodies jump over matched groups and report unclosed ones at the end of the file
+        const std::string src = "function f() { if (a) { b(); } }\nfunction g() { { }";
+        auto source = lexer::create_lexer(src, src.size());
+        source.match_brackets = true;
+        lexer::tokenize(source);
+        const ast::Ast unclosed = parser::parse(source, { .lazy_bodies = true });
+        assert(unclosed.errors.size() == 1);
+        assert(parser::format_error(source, unclosed.errors[0]) == "2:19: expected RIGHT_BRACE, found END_OF_FILE");
+        const std::string ok = "function f() { if (a) { b(); } } var x = 1;";
+        auto matched = lexer::create_lexer(ok, ok.size());
+        matched.match_brackets = true;
+        lexer::tokenize(matched);
+        const ast::Ast tree = parser::parse(matched, { .lazy_bodies = true });
+        [[maybe_unused]] const ast::node_id body = tree.children(tree.children(tree.root)[0]).back();
+        assert(tree.kind(body) == ast::node_kind::LAZY_BLOCK && tree.begin(body) == 4 && tree.end(body) == 16);
+        assert(tree.kind(tree.children(tree.root)[1]) == ast::node_kind::VARIABLE);
+
+        std::cout << GREEN << "[PASSED]: Bracket matching\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -2,7 +2,7 @@
 
 #include <cassert>
 #include <iostream>
-#include "../lang/include/lexer.h"
+#include "../../lang/include/lexer.h"
 
 inline void complex_tokenization()
 {
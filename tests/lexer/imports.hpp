@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include "../../lang/include/imports.h"
+
+inline void import_scanning()
+{
+    constexpr std::string_view input = "// header\nimport core.util;\nimport io;\nfunction main() -> void { }\nimport late;";
+    [[maybe_unused]] const auto imports = nightglow::lang::scan_imports(input);
+    [[maybe_unused]] const auto malformed = nightglow::lang::scan_imports("import a.;\nimport b;");
+
+    try
+    {
+        assert(imports.size() == 2);
+        assert(imports[0].module == "core.util");
+        assert(imports[1].module == "io");
+        assert(imports[1].token.type == nightglow::lang::token_i::IMPORT);
+        assert(malformed.empty());
+        std::cout << GREEN << "[PASSED]: Import scanning\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include "../../lang/include/lexer.h"
+
+template<typename Layout>
+bool same_tokens(const nightglow::lang::TokenList& expected, const nightglow::lang::BasicTokenList<Layout>& actual)
+{
+    if (expected.size() != actual.size())
+        return false;
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        if (expected.start(i) != actual.start(i) || expected.length(i) != actual.length(i)
+            || expected.type(i) != actual.type(i) || expected.flag(i) != actual.flag(i))
+            return false;
+    }
+    return true;
+}
+
+inline void layout_tokenization()
+{
+    constexpr std::string_view input = "class Point { var x: f64; var y: f64; } function len(p: Point) -> f64 { return p.x * p.x + p.y * p.y; }";
+    auto soa = nightglow::lang::lexer::create_lexer(input.data(), input.size());
+    auto aos = nightglow::lang::lexer::create_lexer<nightglow::lang::aos_layout>(input.data(), input.size());
+    auto aosoa = nightglow::lang::lexer::create_lexer<nightglow::lang::aosoa_layout>(input.data(), input.size());
+    [[maybe_unused]] const nightglow::lang::TokenList* tokens = tokenize(soa);
+    tokenize(aos);
+    tokenize(aosoa);
+
+    try
+    {
+        assert(tokens->size() > nightglow::lang::aosoa_layout::block_size);
+        assert(same_tokens(*tokens, aos.tokens));
+        assert(same_tokens(*tokens, aosoa.tokens));
+        std::cout << GREEN << "[PASSED]: Layout tokenization\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../../lang/include/lexer.h"
+
+namespace limits_detail
+{
+    /**
+     * @brief Tokenizes a source and reports whether the lexer rejected it.
+     */
+    inline bool rejected(const std::string& src)
+    {
+        auto lexer = nightglow::lang::lexer::create_lexer(src, src.size());
+        try
+        {
+            nightglow::lang::lexer::tokenize(lexer);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+inline void token_limits()
+{
+    using namespace nightglow::lang;
+    using limits_detail::rejected;
+    try
+    {
+        // the longest literal a 16-bit token length holds, quotes included, is still one token
+        const std::string longest = "x = \"" + std::string(UINT16_MAX - 2, 's') + "\";";
+        auto lexer = lexer::create_lexer(longest, longest.size());
+        [[maybe_unused]] const TokenList* tokens = lexer::tokenize(lexer);
+        assert(tokens->size() == 5);
+        assert(tokens->types[2] == token_i::STR_LITERAL);
+        assert(tokens->lengths[2] == UINT16_MAX);
+        assert(tokens->types[3] == token_i::SEMICOLON);
+
+        // one byte more would wrap and resume lexing inside the literal, so it is rejected instead
+        assert(rejected("x = \"" + std::string(UINT16_MAX - 1, 's') + "\";"));
+        assert(rejected("x = \"" + std::string(70000, 's') + " \"; y = 1;"));
+        assert(rejected("x = \"" + std::string(70000, 's')));
+        assert(rejected("var " + std::string(70000, 'i') + " = 1;"));
+        assert(rejected("x = " + std::string(70000, '1') + ";"));
+
+        std::cout << GREEN << "[PASSED]: Token limits\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -5,12 +5,56 @@
 
 #include "lexer/basic.hpp"
 #include "lexer/complex.hpp"
+#include "lexer/layouts.hpp"
+#include "lexer/imports.hpp"
+#include "lexer/brackets.hpp"
+#include "lexer/limits.hpp"
+#include "cache/roundtrip.hpp"
+#include "cache/module.hpp"
+#include "packed/roundtrip.hpp"
+#include "pipeline/batches.hpp"
+#include "memory/accounting.hpp"
+#include "ast/arena.hpp"
+#include "parser/expressions.hpp"
+#include "parser/lazy.hpp"
+#include "parser/parallel.hpp"
+#include "parser/incremental.hpp"
+#include "parser/recovery.hpp"
+#include "parser/cst.hpp"
+#include "parser/interface.hpp"
 
 int main()
 {
     // Lexing
     basic_tokenization();
     complex_tokenization();
+    layout_tokenization();
+    import_scanning();
+    bracket_matching();
+    token_limits();
+
+    // Caching
+    cache_roundtrip();
+    module_roundtrip();
+
+    // Compression
+    packed_roundtrip();
+
+    // Pipelining
+    pipeline_batches();
+
+    // Memory
+    memory_accounting();
+
+    // Parsing
+    ast_arena();
+    expression_parsing();
+    lazy_bodies();
+    parallel_parsing();
+    incremental_parsing();
+    error_recovery();
+    lossless_syntax();
+    interface_scan();
 
     std::cout << "\n" << GREEN << "\tAll tests passed successfully\n" << RESET;
     return 0;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <new>
+#include "../../lang/include/allocator.h"
+#include "../../lang/include/lexer.h"
+
+namespace accounting_detail
+{
+    struct hook_counts
+    {
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    inline void* counting_allocate(const size_t bytes, const size_t alignment, void* context)
+    {
+        auto* counts = static_cast<hook_counts*>(context);
+        ++counts->allocations;
+        counts->bytes += bytes;
+        return ::operator new(bytes, std::align_val_t(alignment), std::nothrow);
+    }
+
+    inline void counting_deallocate(void* p, const size_t, const size_t alignment, void*)
+    {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+}
+
+inline void memory_accounting()
+{
+    using namespace nightglow::lang;
+    constexpr std::string_view input = "import std.io;\nfunction main() -> void\n{\n    var x: u32 = 0x1F + 42;\n}\n";
+
+    accounting_detail::hook_counts counts{};
+    memory::set_hooks({ accounting_detail::counting_allocate, accounting_detail::counting_deallocate, &counts });
+    memory::reset();
+    [[maybe_unused]] const uint64_t live_before = memory::snapshot().live_bytes;
+
+    try
+    {
+        {
+            auto lexer = lexer::create_lexer(input, input.size());
+            [[maybe_unused]] const TokenList* tokens = lexer::tokenize(lexer);
+
+            [[maybe_unused]] const memory::stats during = memory::snapshot();
+            assert(counts.allocations > 0);
+            assert(during.allocations == counts.allocations);
+            assert(during.allocated_bytes == counts.bytes);
+            assert(during.live_bytes > live_before);
+            assert(during.peak_bytes >= during.live_bytes);
+            assert(tokens->starts.capacity() >= tokens->size());
+        }
+
+        [[maybe_unused]] const memory::stats after = memory::snapshot();
+        assert(after.live_bytes == live_before);
+        assert(after.deallocations == after.allocations);
+        assert(after.peak_bytes >= after.allocated_bytes / 2);
+
+        memory::set_hooks(memory::default_hooks());
+        std::cout << GREEN << "[PASSED]: Memory accounting\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        memory::set_hooks(memory::default_hooks());
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
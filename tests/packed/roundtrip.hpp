@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../../lang/include/lexer.h"
+#include "../../lang/include/token_packed.h"
+
+inline void packed_roundtrip()
+{
+    std::string input;
+    for (auto i = 0; i < 200; ++i)
+    {
+        input += "@pure function add(a: i32, b: i32) -> i32\n{\n    // sum\n    return a + b * 0x1F;\n}\n";
+    }
+    auto lexer = nightglow::lang::lexer::create_lexer(input, input.size());
+    [[maybe_unused]] const nightglow::lang::TokenList* tokens = tokenize(lexer);
+
+    try
+    {
+        [[maybe_unused]] const auto packed = nightglow::lang::packed::compress(*tokens);
+        [[maybe_unused]] const auto unpacked = nightglow::lang::packed::decompress(packed);
+
+        assert(packed.size() == tokens->size());
+        assert(packed.memory_usage() * 3 <= tokens->size() * 8);
+        assert(unpacked.starts == tokens->starts);
+        assert(unpacked.lengths == tokens->lengths);
+        assert(unpacked.types == tokens->types);
+        assert(unpacked.flags == tokens->flags);
+
+        std::cout << GREEN << "[PASSED]: Packed token round trip\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
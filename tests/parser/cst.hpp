@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../../lang/include/cst.h"
+#include "../../lang/include/parser.h"
+
+inline void lossless_syntax()
+{
+    using namespace nightglow::lang;
+    try
+    {
+        const std::string src = "// header\n"
+                                "var a = 1; // one\n"
+                                "\n"
+                                "/* doc */\n"
+                                "function f() {\n"
+                                "    return a $ ; /* two */\n"
+                                "}\n"
+                                "/* end */\n";
+
+        // off by default
+        auto plain = lexer::create_lexer(src, src.size());
+        lexer::tokenize(plain);
+        assert(plain.tokens.trivia.empty());
+
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer.keep_trivia = true;
+        const TokenList* tokens = lexer::tokenize(lexer);
+        assert(std::ranges::equal(tokens->starts, plain.tokens.starts) && std::ranges::equal(tokens->types, plain.tokens.types));
+
+        // tokens and trivia together give back every byte, in order
+        std::string rebuilt;
+        size_t next = 0;
+        for (uint32_t i = 0; i < tokens->size(); ++i)
+        {
+            for (; next < tokens->trivia.size() && tokens->trivia[next].token == i; ++next)
+            {
+                const trivia_t& run = tokens->trivia[next];
+                assert(run.start == rebuilt.size());
+                rebuilt.append(src, run.start, run.length);
+            }
+            rebuilt += lexer::get_token_value(lexer, (*tokens)[i]);
+        }
+        assert(next == tokens->trivia.size());
+        assert(rebuilt == src);
+
+        const ast::Ast tree = parser::parse(lexer);
+        const cst::View view{ lexer, tree };
+        const auto module = tree.children(tree.root);
+        assert(module.size() == 2);
+
+        // a comment on the statement's line trails it; the ones above a declaration lead it
+        [[maybe_unused]] const auto trailing = view.trailing(module[0]);
+        assert(trailing.size() == 2 && view.text(trailing[1]) == "// one" && trailing[1].kind == trivia_kind::LINE_COMMENT);
+        [[maybe_unused]] const auto leading = view.leading(module[1]);
+        assert(leading.size() == 3 && view.text(leading[1]) == "/* doc */" && leading[1].kind == trivia_kind::BLOCK_COMMENT);
+        assert(view.leading(module[0]).size() == 2 && view.text(view.leading(module[0])[0]) == "// header");
+
+        assert(view.text(module[0]) == "var a = 1;");
+        assert(view.full_text(module[0]) == "// header\nvar a = 1; // one");
+        assert(view.full_text(module[1]).starts_with("\n\n/* doc */\nfunction f() {"));
+        assert(view.full_text(module[1]).ends_with("}\n/* end */\n"));
+        assert(view.full_text(tree.root) == src);
+
+        // the dropped character is kept as skipped trivia
+        [[maybe_unused]] const auto skipped = std::ranges::find(tokens->trivia, trivia_kind::SKIPPED, &trivia_t::kind);
+        assert(skipped != tokens->trivia.end() && src.substr(skipped->start, skipped->length) == "$");
+
+        std::cout << GREEN << "[PASSED]: Lossless syntax\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
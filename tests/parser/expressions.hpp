@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <span>
+#include <string>
+#include <vector>
+#include "../../lang/include/parser.h"
+
+namespace expressions_detail
+{
+    /**
+     * @brief Stream buffer that only counts the lines written through it, for dumps too large to keep.
+     */
+    struct line_counter : std::streambuf
+    {
+        size_t count = 0;
+
+    protected:
+        int_type overflow(const int_type c) override
+        {
+            count += c == '\n';
+            return c;
+        }
+
+        std::streamsize xsputn(const char* s, const std::streamsize n) override
+        {
+            for (const char* end = s + n; (s = static_cast<const char*>(std::memchr(s, '\n', end - s))); ++s)
+                ++count;
+            return n;
+        }
+    };
+
+    /**
+     * @brief Parses "var v = <expression>;" and prints the expression back fully parenthesized, or the first
+     * syntax error.
+     */
+    inline std::string shape(const std::string& expression)
+    {
+        using namespace nightglow::lang;
+        const std::string src = "var v = " + expression + ";";
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::tokenize(lexer);
+        const ast::Ast tree = parser::parse(lexer);
+        if (tree.errors.size() != 0)
+            return parser::format_error(lexer, tree.errors[0]);
+
+        // an explicit stack of unvisited siblings keeps deep chains off the native stack
+        std::ostringstream out;
+        std::vector<std::span<const ast::node_id>> pending;
+        const auto open = [&](const ast::node_id id)
+        {
+            const auto children = tree.children(id);
+            const std::string_view text = lexer::get_token_value(lexer, lexer.tokens[tree.token(id)]);
+            if (children.empty())
+            {
+                out << text;
+                return;
+            }
+            out << '(' << text;
+            pending.push_back(children);
+        };
+        const ast::node_id variable = tree.children(tree.root)[0];
+        open(tree.children(variable)[0]);
+        while (!pending.empty())
+        {
+            std::span<const ast::node_id>& siblings = pending.back();
+            if (siblings.empty())
+            {
+                out << ')';
+                pending.pop_back();
+                continue;
+            }
+            const ast::node_id child = siblings.front();
+            siblings = siblings.subspan(1);
+            out << ' ';
+            open(child);
+        }
+        return out.str();
+    }
+}
+
+inline void expression_parsing()
+{
+    using expressions_detail::shape;
+    try
+    {
+        assert(shape("a + b * c") == "(+ a (* b c))");
+        assert(shape("a * b + c") == "(+ (* a b) c)");
+        assert(shape("a - b - c") == "(- (- a b) c)");
+        assert(shape("a = b = c") == "(= a (= b c))");
+        assert(shape("a || b && c | d ^ e & f == g < h << i + j * k") == "(|| a (&& b (| c (^ d (& e (== f (< g (<< h (+ i (* j k))))))))))");
+        assert(shape("-a.b * !c") == "(* (- (b a)) (! c))");
+        assert(shape("(a + b) * c") == "(* (+ a b) c)");
+        assert(shape("f(a, b + 1)[i].x") == "(x ([ (( f a (+ b 1)) i))");
+        assert(shape("f()") == "(( f)");
+        assert(shape("a ? b : c ? d : e") == "(? a b (? c d e))");
+        assert(shape("x += a > b ? 1 : 2") == "(+= x (? (> a b) 1 2))");
+        assert(shape("new Vec(1, 2)") == "(new (( Vec 1 2))");
+
+        // nesting depth is bounded by memory, not by the native stack
+        const std::string deep = std::string(100000, '(') + "1" + std::string(100000, ')');
+        assert(shape(deep) == "1");
+        std::string chain = "a";
+        std::string nested;
+        for (auto i = 0; i < 50000; ++i)
+        {
+            chain += " = a";
+            nested += "(= a ";
+        }
+        assert(shape(chain) == nested + "a" + std::string(50000, ')'));
+
+        // ast::dump walks the same chain without recursing either
+        const std::string src = "var v = " + chain + ";";
+        auto lexer = nightglow::lang::lexer::create_lexer(src, src.size());
+        nightglow::lang::lexer::tokenize(lexer);
+        const auto tree = nightglow::lang::parser::parse(lexer);
+        expressions_detail::line_counter lines;
+        std::ostream dumped(&lines);
+        nightglow::lang::ast::dump(dumped, tree, lexer);
+        assert(lines.count == 2 + 50000 + 50001);
+
+        assert(shape("a + * b") == "1:13: expected expression, found STAR '*'");
+        assert(shape("f(a, ") == "1:14: expected expression, found SEMICOLON ';'");
+
+        std::cout << GREEN << "[PASSED]: Expression parsing\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
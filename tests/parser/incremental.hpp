@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../../lang/include/incremental.h"
+
+namespace incremental_detail
+{
+    /**
+     * @brief Settles a document and checks that its tokens, line starts, tree and errors match lexing and parsing
+     * its text from scratch.
+     */
+    inline bool matches_fresh(nightglow::lang::incremental::Document& document)
+    {
+        using namespace nightglow::lang;
+        incremental::settle(document);
+        auto lexer = lexer::create_lexer(document.text, document.text.size());
+        lexer::tokenize(lexer);
+        if (lexer.tokens.starts != document.lexer.tokens.starts || lexer.tokens.lengths != document.lexer.tokens.lengths
+            || lexer.tokens.types != document.lexer.tokens.types || lexer.line_starts != document.lexer.line_starts)
+            return false;
+
+        const ast::Ast fresh = parser::parse(lexer);
+        if (fresh.errors.size() != document.ast.errors.size())
+            return false;
+        for (uint32_t i = 0; i < fresh.errors.size(); ++i)
+        {
+            if (fresh.errors[i].token != document.ast.errors[i].token || fresh.errors[i].expected != document.ast.errors[i].expected)
+                return false;
+        }
+
+        std::ostringstream expected, actual;
+        ast::dump(expected, fresh, lexer);
+        ast::dump(actual, document.ast, document.lexer);
+        return expected.str() == actual.str();
+    }
+}
+
+inline void incremental_parsing()
+{
+    using namespace nightglow::lang;
+    using incremental_detail::matches_fresh;
+    try
+    {
+        std::string src = "import io;\n";
+        for (auto i = 0; i < 200; ++i)
+        {
+            const std::string n = std::to_string(i);
+            src += "function fun" + n + "(a: i32) -> i32\n{\n    var x = a * " + n + ";\n    if (x > 10) { return x; }\n    return a;\n}\n";
+        }
+        auto document = incremental::open_document(src);
+        // matches_fresh() also settles the document, which each step below needs before it reads the text
+        [[maybe_unused]] bool fresh = false;
+        const auto functions = document.ast.children(document.ast.root);
+        [[maybe_unused]] const ast::node_id first = functions[1];
+        [[maybe_unused]] const ast::node_id last = functions.back();
+        [[maybe_unused]] const ast::node_id edited = functions[100];
+
+        // change a literal inside one body: only that statement is parsed again
+        const auto literal = static_cast<uint32_t>(document.text.find("a * 100;"));
+        auto stats = incremental::apply_edit(document, { literal + 4, 3, "4200 + b" });
+        assert(!stats.full && stats.relexed_tokens <= 6 && stats.reparsed_tokens < 16);
+        fresh = matches_fresh(document);
+        assert(fresh);
+        assert(document.ast.children(document.ast.root)[1] == first);
+        assert(document.ast.children(document.ast.root).back() == last);
+        assert(document.ast.children(document.ast.root)[100] == edited);
+
+        // insert a statement, then remove it again
+        const auto body = static_cast<uint32_t>(document.text.find("return a;", literal));
+        stats = incremental::apply_edit(document, { body, 0, "while (a < 3) { a += 1; }\n    " });
+        fresh = matches_fresh(document);
+        assert(!stats.full && fresh);
+        stats = incremental::apply_edit(document, { body, 30, "" });
+        fresh = matches_fresh(document);
+        assert(!stats.full && fresh);
+
+        // whitespace and comments shift tokens without touching the tree
+        [[maybe_unused]] const uint32_t nodes = document.ast.size();
+        stats = incremental::apply_edit(document, { 0, 0, "// header\n\n" });
+        fresh = matches_fresh(document);
+        assert(stats.reparsed_tokens == 0 && document.ast.size() == nodes && fresh);
+
+        // an edit at the end of a statement can extend it
+        const auto branch = static_cast<uint32_t>(document.text.find("return x; }", literal)) + 11;
+        stats = incremental::apply_edit(document, { branch, 0, " else { return 0; }" });
+        fresh = matches_fresh(document);
+        assert(!stats.full && fresh);
+
+        // opening a block comment swallows the rest of the file, closing it brings it back
+        const auto middle = static_cast<uint32_t>(document.text.find("function fun150"));
+        incremental::apply_edit(document, { middle, 0, "/*" });
+        fresh = matches_fresh(document);
+        assert(fresh);
+        incremental::apply_edit(document, { middle, 2, "" });
+        fresh = matches_fresh(document);
+        assert(fresh);
+
+        // a stray brace is recovered from in place, an unclosed one swallows the rest and needs a full parse
+        stats = incremental::apply_edit(document, { middle, 0, "}" });
+        fresh = matches_fresh(document);
+        assert(!stats.full && fresh && document.ast.errors.size() == 1);
+        stats = incremental::apply_edit(document, { middle, 1, "" });
+        fresh = matches_fresh(document);
+        assert(fresh && document.ast.errors.size() == 0);
+        stats = incremental::apply_edit(document, { middle, 0, "{" });
+        fresh = matches_fresh(document);
+        assert(stats.full && fresh && document.ast.errors.size() == 1);
+        stats = incremental::apply_edit(document, { middle, 1, "" });
+        fresh = matches_fresh(document);
+        assert(fresh && document.ast.errors.size() == 0);
+
+        // a half-typed statement keeps the edit local, and so does finishing it
+        const auto typing = static_cast<uint32_t>(document.text.find("return a;", middle));
+        stats = incremental::apply_edit(document, { typing, 0, "var half = a +\n    " });
+        fresh = matches_fresh(document);
+        assert(!stats.full && fresh && document.ast.errors.size() == 1);
+        stats = incremental::apply_edit(document, { typing + 14, 0, " 1;" });
+        fresh = matches_fresh(document);
+        assert(!stats.full && fresh && document.ast.errors.size() == 0);
+
+        // many small edits stay correct across compactions
+        for (auto i = 0; i < 300; ++i)
+        {
+            const size_t at = document.text.find("var x = a", static_cast<size_t>(i) * 97 % document.text.size());
+            if (at == std::string::npos)
+                continue;
+            incremental::apply_edit(document, { static_cast<uint32_t>(at) + 4, 1, i % 2 ? "y" : "x1" });
+            fresh = matches_fresh(document);
+            assert(fresh);
+        }
+        assert(document.garbage <= document.ast.size());
+
+        // edits on both sides of earlier ones, with the token shifts they leave pending until the document settles
+        std::vector<uint32_t> sites;
+        for (size_t at = document.text.find("var x = a"); at != std::string::npos && sites.size() < 12; at = document.text.find("var x = a", at + 4000))
+        {
+            sites.push_back(static_cast<uint32_t>(at) + 9);
+        }
+        for (size_t i = 0; i < sites.size(); i += 2)
+        {
+            stats = incremental::apply_edit(document, { static_cast<uint32_t>(sites[i] + i / 2 * 4), 0, " + 1" });
+            assert(!stats.full);
+        }
+        for (size_t i = sites.size() - 1; i < sites.size(); i -= 2)
+        {
+            stats = incremental::apply_edit(document, { static_cast<uint32_t>(sites[i] + (i + 1) / 2 * 4), 0, " * (b)" });
+            assert(!stats.full);
+        }
+        fresh = matches_fresh(document);
+        assert(fresh);
+
+        // an edit inside a deep expression counts the nodes it replaces without recursing
+        std::string chain = "var v = ";
+        for (auto i = 0; i < 2000000; ++i)
+        {
+            chain += "a = ";
+        }
+        chain += "a;\nvar w = 1;\n";
+        auto deep = incremental::open_document(chain);
+        stats = incremental::apply_edit(deep, { static_cast<uint32_t>(chain.size()) - 14, 1, "b" });
+        assert(stats.replaced_nodes > 4000000);
+
+        std::cout << GREEN << "[PASSED]: Incremental parsing\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../../lang/include/parser.h"
+#include "../../lang/include/precompiled.h"
+
+namespace interface_detail
+{
+    /**
+     * @brief Compares two interfaces record by record, with strings resolved.
+     */
+    inline bool same_interface(const nightglow::lang::precompiled::Interface& a, const nightglow::lang::precompiled::Interface& b)
+    {
+        using namespace nightglow::lang::precompiled;
+        const auto same = [&](const string_ref x, const string_ref y) { return a.string(x) == b.string(y); };
+        if (a.decls.size() != b.decls.size() || a.params.size() != b.params.size() || a.annotations.size() != b.annotations.size()
+            || a.imports.size() != b.imports.size())
+            return false;
+        for (size_t i = 0; i < a.decls.size(); ++i)
+        {
+            const decl_record& x = a.decls[i];
+            const decl_record& y = b.decls[i];
+            if (!same(x.name, y.name) || !same(x.type, y.type) || x.kind != y.kind || x.flags != y.flags || x.line != y.line || x.parent != y.parent
+                || x.first_param != y.first_param || x.param_count != y.param_count || x.first_annotation != y.first_annotation
+                || x.annotation_count != y.annotation_count)
+                return false;
+        }
+        for (size_t i = 0; i < a.params.size(); ++i)
+        {
+            if (!same(a.params[i].name, b.params[i].name) || !same(a.params[i].type, b.params[i].type) || a.params[i].has_default != b.params[i].has_default)
+                return false;
+        }
+        for (size_t i = 0; i < a.annotations.size(); ++i)
+        {
+            if (!same(a.annotations[i], b.annotations[i]))
+                return false;
+        }
+        for (size_t i = 0; i < a.imports.size(); ++i)
+        {
+            if (!same(a.imports[i], b.imports[i]))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Scans a source with and without matched brackets and checks both against the parsed interface.
+     */
+    inline bool scan_matches_parse(const std::string& src)
+    {
+        using namespace nightglow::lang;
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::tokenize(lexer);
+        const precompiled::Interface scanned = precompiled::scan(lexer);
+        parser::parse_options options;
+        options.lazy_bodies = true;
+        const precompiled::Interface parsed = precompiled::extract(lexer, parser::parse(lexer, options));
+
+        auto matched = lexer::create_lexer(src, src.size());
+        matched.match_brackets = true;
+        lexer::tokenize(matched);
+        return same_interface(scanned, parsed) && scanned.strings == parsed.strings && same_interface(precompiled::scan(matched), parsed);
+    }
+}
+
+inline void interface_scan()
+{
+    using namespace nightglow::lang;
+    using interface_detail::scan_matches_parse;
+    try
+    {
+        const std::string src = "import core.io;\n"
+                                "import util;\n"
+                                "@pure @align(8)\n"
+                                "public inline function add(a: i32, b: i32 = max(1, (2)), c: core.Vec[]? = nil) -> i32 { if (a) { return b; } else { return a + b; } }\n"
+                                "async function wait();\n"
+                                "class Point extends Base {\n"
+                                "    public var x: f64 = 0;\n"
+                                "    private var y: f64;\n"
+                                "    private function hidden() { var z = 1; }\n"
+                                "    @deprecated function len() -> f64 { return x; }\n"
+                                "    class Inner { const depth: u8 = 3; }\n"
+                                "}\n"
+                                "enum Color { RED, GREEN = 2 + (3), BLUE }\n"
+                                "x = f(1, (2));\n"
+                                "if (x) { var local = 1; } else if (y) { } else { }\n"
+                                "while (true) { function nested() {} }\n"
+                                "@nodiscard const limit: u32 = 10;\n";
+        assert(scan_matches_parse(src));
+
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::tokenize(lexer);
+        [[maybe_unused]] const precompiled::Interface scanned = precompiled::scan(lexer);
+        assert(scanned.imports.size() == 2 && scanned.string(scanned.imports[0]) == "core.io");
+        // add, wait, Point with x, len and Inner with depth, Color with three enumerators, limit
+        assert(scanned.decls.size() == 12);
+        assert(scanned.string(scanned.params[2].type) == "core.Vec[]?" && scanned.params[2].has_default);
+        assert(scanned.decls[0].flags == (precompiled::PUBLIC | precompiled::INLINE | precompiled::HAS_BODY));
+        assert(scanned.decls[1].flags == precompiled::ASYNC);
+
+        // what the build driver writes for dependents loads back as the same declarations
+        const std::filesystem::path dir = std::filesystem::temp_directory_path() / "nightglow-interface-test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        [[maybe_unused]] const bool written = precompiled::write(precompiled::module_path(dir, src), scanned, src);
+        assert(written);
+        const auto mapped = precompiled::load(dir, src);
+        if (!mapped.has_value())
+            throw std::runtime_error("scanned interface was not loaded");
+        assert(mapped->decls.size() == scanned.decls.size() && mapped->imports.size() == 2);
+        [[maybe_unused]] const auto point = mapped->materialize(mapped->find("Point"));
+        assert(point.type == "Base" && mapped->materialize(mapped->find("limit")).flags == precompiled::CONSTANT);
+        std::filesystem::remove_all(dir);
+
+        assert(scan_matches_parse(""));
+        assert(scan_matches_parse("import a.b.c;\nvar x = 1;"));
+
+        // broken sources never read past the tokens, whether or not brackets were matched
+        for (const std::string broken : { "function f(a: , b = ) -> { ", "class C extends { var x = (1; }", "enum E { A = , }",
+                                          "@pure private", "} ) ] import x; function", "class { class { class {" })
+        {
+            auto broken_lexer = lexer::create_lexer(broken, broken.size());
+            broken_lexer.match_brackets = broken.size() % 2 == 0;
+            lexer::tokenize(broken_lexer);
+            precompiled::scan(broken_lexer);
+        }
+
+        std::cout << GREEN << "[PASSED]: Interface scan\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
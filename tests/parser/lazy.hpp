@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "../../lang/include/parser.h"
+
+inline void lazy_bodies()
+{
+    using namespace nightglow::lang;
+    try
+    {
+        const std::string src =
+            "import io;\n"
+            "@pure function add(a: i32, b: i32) -> i32 { if (a > b) { return a; } return a + b; }\n"
+            "function forward(x: i32) -> i32;\n"
+            "class Box { function get() -> i32 { return (1 + 2) * 3; } var v: i32 = 2; }\n";
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::tokenize(lexer);
+
+        const ast::Ast eager = parser::parse(lexer);
+        ast::Ast lazy = parser::parse(lexer, { .lazy_bodies = true });
+        assert(lazy.size() < eager.size());
+
+        const auto module = lazy.children(lazy.root);
+        const ast::node_id add = module[1];
+        [[maybe_unused]] const ast::node_id skipped = lazy.children(add).back();
+        assert(lazy.kind(skipped) == ast::node_kind::LAZY_BLOCK);
+        assert(lazy.children(skipped).empty());
+        assert(lexer.tokens.types[lazy.begin(skipped)] == token_i::LEFT_BRACE);
+        assert(lexer.tokens.types[lazy.end(skipped) - 1] == token_i::RIGHT_BRACE);
+        assert(lazy.end(add) == lazy.end(skipped));
+
+        // a declaration without a body has nothing to materialize
+        assert(parser::materialize_body(lazy, lexer, module[2]) == ast::no_node);
+
+        // materialized bodies match the eager tree, and existing handles stay valid
+        [[maybe_unused]] const ast::node_id body = parser::materialize_body(lazy, lexer, add);
+        assert(lazy.kind(body) == ast::node_kind::BLOCK);
+        assert(lazy.children(add).back() == body);
+        assert(parser::materialize_body(lazy, lexer, add) == body);
+        assert(lazy.kind(module[1]) == ast::node_kind::FUNCTION);
+
+        const ast::node_id get = lazy.children(module[3])[0];
+        parser::materialize_body(lazy, lexer, get);
+
+        std::ostringstream expected, actual;
+        ast::dump(expected, eager, lexer);
+        ast::dump(actual, lazy, lexer);
+        assert(actual.str() == expected.str());
+
+        // errors inside a body surface when it is materialized, and the body is still linked
+        const std::string broken = "function f() { return * 1; }";
+        auto broken_lexer = lexer::create_lexer(broken, broken.size());
+        lexer::tokenize(broken_lexer);
+        ast::Ast tree = parser::parse(broken_lexer, { .lazy_bodies = true });
+        assert(tree.errors.size() == 0);
+        const ast::node_id function = tree.children(tree.root)[0];
+        [[maybe_unused]] const ast::node_id broken_body = parser::materialize_body(tree, broken_lexer, function);
+        assert(tree.kind(broken_body) == ast::node_kind::BLOCK && tree.children(function).back() == broken_body);
+        assert(tree.errors.size() == 1);
+        assert(parser::format_error(broken_lexer, tree.errors[0]) == "1:23: expected expression, found STAR '*'");
+
+        std::cout << GREEN << "[PASSED]: Lazy function bodies\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
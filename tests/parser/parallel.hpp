@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../../lang/include/parser.h"
+
+namespace parallel_detail
+{
+    inline bool same_tree(const nightglow::lang::ast::Ast& a, const nightglow::lang::ast::Ast& b)
+    {
+        if (a.size() != b.size() || a.edges.size() != b.edges.size() || a.root != b.root)
+            return false;
+        for (uint32_t i = 0; i < a.size(); ++i)
+        {
+            if (a.kinds[i] != b.kinds[i] || a.tokens[i] != b.tokens[i] || a.begins[i] != b.begins[i] || a.ends[i] != b.ends[i]
+                || a.child_begins[i] != b.child_begins[i] || a.child_counts[i] != b.child_counts[i])
+                return false;
+        }
+        for (uint32_t i = 0; i < a.edges.size(); ++i)
+        {
+            if (a.edges[i] != b.edges[i])
+                return false;
+        }
+        return true;
+    }
+}
+
+inline void parallel_parsing()
+{
+    using namespace nightglow::lang;
+    using parallel_detail::same_tree;
+    try
+    {
+        std::string src = "import io;\nimport core.math;\n";
+        for (auto i = 0; i < 3000; ++i)
+        {
+            const std::string n = std::to_string(i);
+            src += "@pure function fun" + n + "(a: i32, b: i32 = 2) -> i32 { if (a > b) { return a; } else { return b * (a + " + n + "); } }\n";
+            src += "class C" + n + " extends Base { public var x: f64[] = nil; function get() -> f64 { return x[0]; } }\n";
+            src += "enum E" + n + " { A, B = " + n + " }\nvar g" + n + " = fun" + n + "(1, 2);\n";
+            src += "if (g" + n + " > 0) { g" + n + " = 0; } else g" + n + " = 1;\nfor (var i = 0; i < 3; i += 1) { }\n";
+        }
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::tokenize(lexer);
+        assert(lexer.tokens.size() > 4 * parser::min_tokens_per_thread);
+
+        // runs are contiguous whole statements ending at the end of the file
+        const auto runs = parser::split_declarations(lexer.tokens, 8, 4);
+        assert(runs.size() == 4 && runs[0].begin == 8 && runs.back().end == lexer.tokens.size() - 1);
+        for (size_t i = 1; i < runs.size(); ++i)
+        {
+            assert(runs[i].begin == runs[i - 1].end);
+            [[maybe_unused]] const token_i last = lexer.tokens.types[runs[i].begin - 1];
+            assert(last == token_i::SEMICOLON || last == token_i::RIGHT_BRACE);
+            assert(lexer.tokens.types[runs[i].begin] != token_i::ELSE);
+        }
+
+        // the runs are really parsed apart and merged, not handed back to a serial parse
+        const ast::Ast serial = parser::parse(lexer);
+        parser::parse_stats stats{};
+        const ast::Ast parallel = parser::parse(lexer, { .threads = 4 }, stats);
+        assert(stats.runs == 4 && same_tree(parallel, serial));
+        assert(same_tree(parser::parse(lexer, { .threads = 0 }), serial));
+        assert(same_tree(parser::parse(lexer, { .lazy_bodies = true, .threads = 3 }), parser::parse(lexer, { .lazy_bodies = true })));
+
+        auto matched = lexer::create_lexer(src, src.size());
+        matched.match_brackets = true;
+        lexer::tokenize(matched);
+        assert(same_tree(parser::parse(matched, { .threads = 4 }), serial));
+
+        // errors and recovery are the same as in a serial parse
+        std::string broken = src;
+        broken.insert(broken.find("\nvar g", broken.size() / 2) + 1, "var broken = ;\n");
+        broken.insert(broken.find("\nvar g", broken.size() * 3 / 4) + 1, "var later = ;\n");
+        auto broken_lexer = lexer::create_lexer(broken, broken.size());
+        lexer::tokenize(broken_lexer);
+        const ast::Ast broken_serial = parser::parse(broken_lexer);
+        const ast::Ast broken_parallel = parser::parse(broken_lexer, { .threads = 4 }, stats);
+        assert(stats.runs == 4 && broken_serial.errors.size() == 2 && same_tree(broken_parallel, broken_serial));
+        assert(broken_parallel.errors.size() == 2);
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            assert(broken_parallel.errors[i].token == broken_serial.errors[i].token);
+        }
+
+        std::cout << GREEN << "[PASSED]: Parallel parsing\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../../lang/include/parser.h"
+
+namespace recovery_detail
+{
+    /**
+     * @brief Parses a source and returns its syntax errors, formatted and one per line.
+     */
+    inline std::string errors_of(const std::string& src, nightglow::lang::ast::Ast* out = nullptr)
+    {
+        using namespace nightglow::lang;
+        auto lexer = lexer::create_lexer(src, src.size());
+        lexer::tokenize(lexer);
+        ast::Ast tree = parser::parse(lexer);
+        std::string errors;
+        for (uint32_t i = 0; i < tree.errors.size(); ++i)
+        {
+            errors += parser::format_error(lexer, tree.errors[i]) + "\n";
+        }
+        if (out != nullptr)
+            *out = std::move(tree);
+        return errors;
+    }
+}
+
+inline void error_recovery()
+{
+    using namespace nightglow::lang;
+    using recovery_detail::errors_of;
+    try
+    {
+        assert(errors_of("var a = 1;\nfunction f() { return a; }").empty());
+
+        // one error per broken statement; each resynchronizes on the next ; or } or declaration keyword
+        ast::Ast tree;
+        const std::string src = "var a = ;\n"
+                                "function f(x: ) { return x; }\n"
+                                "class C { var x = 1 var y = 2; }\n"
+                                "var ok = 2;\n";
+        [[maybe_unused]] const std::string errors = errors_of(src, &tree);
+        assert(errors == "1:9: expected expression, found SEMICOLON ';'\n"
+                          "2:15: expected a type, found RIGHT_PAREN ')'\n"
+                          "3:21: expected SEMICOLON, found VAR 'var'\n");
+        const auto module = tree.children(tree.root);
+        assert(module.size() == 5);
+        assert(tree.kind(module[0]) == ast::node_kind::VARIABLE && tree.kind(tree.children(module[0])[0]) == ast::node_kind::ERROR);
+        assert(tree.kind(module[1]) == ast::node_kind::FUNCTION);
+        assert(tree.kind(module[2]) == ast::node_kind::ERROR && tree.end(module[2]) == tree.begin(module[3]));
+        assert(tree.kind(module[3]) == ast::node_kind::CLASS && tree.children(module[3]).size() == 2);
+        assert(tree.kind(module[4]) == ast::node_kind::VARIABLE);
+
+        // a block left open reports once, at the end of the file
+        assert(errors_of("function f() { if (a) { b(); }\nvar c = 1;") == "2:11: expected RIGHT_BRACE, found END_OF_FILE\n");
+
+        // stray closers and garbage are skipped without cascading
+        assert(errors_of("} ) ]\nvar a = 1;") == "1:1: expected expression, found RIGHT_BRACE '}'\n"
+                                                "1:3: expected expression, found RIGHT_PAREN ')'\n");
+        std::string garbage;
+        for (auto i = 0; i < 2000; ++i)
+        {
+            garbage += ") ( ] { , . = ; } var function class const @ ";
+        }
+        errors_of(garbage, &tree);
+        assert(tree.kind(tree.root) == ast::node_kind::MODULE && tree.errors.size() > 2000);
+        for (uint32_t i = 1; i < tree.errors.size(); ++i)
+        {
+            assert(tree.errors[i - 1].token < tree.errors[i].token);
+        }
+
+        std::cout << GREEN << "[PASSED]: Error recovery\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "../../lang/include/pipeline.h"
+
+inline void pipeline_batches()
+{
+    std::string input;
+    for (auto i = 0; i < 2000; ++i)
+    {
+        input += "var x: i32 = (a + b) * c; // pipelined\n";
+    }
+
+    auto reference = nightglow::lang::lexer::create_lexer(input, input.size());
+    [[maybe_unused]] const nightglow::lang::TokenList* tokens = tokenize(reference);
+
+    auto lexer = nightglow::lang::lexer::create_lexer(input, input.size());
+    nightglow::lang::TokenList streamed;
+    uint32_t batches = 0;
+    nightglow::lang::pipeline::run(lexer, [&](const nightglow::lang::pipeline::token_batch& batch)
+    {
+        for (uint32_t i = 0; i < batch.size; ++i)
+        {
+            streamed.push_back(batch.tokens[i]);
+        }
+        ++batches;
+    });
+
+    try
+    {
+        assert(batches > nightglow::lang::pipeline::ring_capacity);
+        assert(streamed.starts == tokens->starts);
+        assert(streamed.types == tokens->types);
+        assert(lexer.line_starts == reference.line_starts);
+        std::cout << GREEN << "[PASSED]: Pipelined tokenization\n" << RESET;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << RED << "[FAILED]: " << e.what() << RESET << "\n";
+    }
+}